@@ -0,0 +1,651 @@
+//
+// Matlab MEX file
+//
+// CLOSURE_HELPER Match the final points of a set of trajectories to
+// their initial points so as to minimize the sum of the Euclidean
+// distances.  Used by closure(XY,'MinDist') and by the closure check
+// in colorbraiding.
+//
+// <LICENSE
+//   Braidlab: a Matlab package for analyzing data using braids
+//
+//   https://github.com/jeanluct/braidlab
+//
+//   Copyright (C) 2013-2026  Jean-Luc Thiffeault <jeanluc@math.wisc.edu>
+//                            Marko Budisic          <mbudisic@gmail.com>
+//
+//   This file is part of Braidlab.
+//
+//   Braidlab is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   Braidlab is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
+// LICENSE>
+
+// The Matlab version builds the full n x n distance matrix and hands
+// it to the Hungarian algorithm, which is O(n^3).  Here the distances
+// are never stored densely: a uniform grid over the initial points
+// gives each final point a short list of nearest candidates, and the
+// assignment is solved on that sparse graph by Bertsekas' auction
+// algorithm with epsilon-scaling.  Edges outside the lists are added
+// whenever the final prices show that they could improve the matching,
+// so the result is optimal for the full problem (to within n times the
+// final epsilon).  If the optimal matching turns out not to be local,
+// so that too many edges have to be added, the auction is rerun with
+// every initial point as a candidate, computing distances as needed.
+// With several threads, large rounds of bids are computed in parallel.
+
+#if ( (defined __GNUC__) && (!defined __clang__) )
+#define GCCVERSION (__GNUC__ * 10000            \
+                    + __GNUC_MINOR__ * 100      \
+                    + __GNUC_PATCHLEVEL__)
+# if ( (!defined BRAIDLAB_NOTHREADING) &&           \
+       ( GCCVERSION < 40600) ) // less than GCC 4.5
+# define BRAIDLAB_NOTHREADING
+# endif
+#endif // gcc
+
+#if (defined __clang__)
+#define CLANGVERSION (__clang_major__ * 10000   \
+                      + __clang_minor__ * 100   \
+                      + __clang_patchlevel__)
+# if ( (!defined BRAIDLAB_NOTHREADING) &&               \
+       (CLANGVERSION < 30300) ) // less than Clang 3.3
+# define BRAIDLAB_NOTHREADING
+# endif
+#endif // clang
+
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+
+#ifndef BRAIDLAB_NOTHREADING
+#include <future>
+#include <memory>
+#include "ThreadPool.h" // (c) Jakob Progsch, Václav Zeman
+                        // https://github.com/progschj/ThreadPool
+#endif
+
+#include "mex.h"
+
+/*
+*** Inputs:
+XY       - nT x 2 x n trajectories (double or single)
+Nthreads - (optional) number of threads used for bidding (default 1)
+
+*** Outputs:
+perm     - 1 x n vector: final point i is matched to initial point perm(i)
+XYc      - (nT+1) x 2 x n closed trajectories, [XY ; XY(1,:,perm)]
+cost     - sum of the distances between matched points
+*/
+
+#define p_XY       (prhs[0])
+#define p_Nthreads (prhs[1])
+
+// Number of nearest candidates per point.
+#ifndef CLOSURE_NCANDIDATES
+#define CLOSURE_NCANDIDATES 20
+#endif
+// Up to this many strings the candidate lists are not worth building.
+#ifndef CLOSURE_DENSE
+#define CLOSURE_DENSE 256
+#endif
+// Factor by which epsilon is reduced from one phase to the next.
+#ifndef CLOSURE_EPSFACTOR
+#define CLOSURE_EPSFACTOR 5
+#endif
+// Below this many bidders a round of bids is not worth farming out to
+// threads, and bids are made one at a time instead.
+#define CLOSURE_MINPARALLELBIDDERS 1024
+// Marks a bidder or object that is not assigned.
+#define UNASSIGNED ((size_t)-1)
+
+// Bucket the initial points into a uniform grid with about two points
+// per cell, for nearest-neighbor queries.
+class PointGrid
+{
+public:
+  PointGrid(const std::vector<double>& x, const std::vector<double>& y)
+    : x_(x), y_(y)
+  {
+    const size_t n = x.size();
+    xmin_ = *std::min_element(x.begin(),x.end());
+    ymin_ = *std::min_element(y.begin(),y.end());
+    double w = *std::max_element(x.begin(),x.end()) - xmin_;
+    double h = *std::max_element(y.begin(),y.end()) - ymin_;
+    double side = std::max(w,h);
+    if (side == 0) side = 1;
+    // Aim for about two points per cell; degenerate (collinear) sets
+    // are bucketed along their long side.
+    size_t ncell = std::max((size_t)1,
+                            (size_t)std::ceil(std::sqrt(n/2.0)));
+    cell_ = side / ncell;
+    nx_ = std::min(ncell,(size_t)(w/cell_)+1);
+    ny_ = std::min(ncell,(size_t)(h/cell_)+1);
+
+    // Counting sort of the points into cells (CSR layout).
+    start_.assign(nx_*ny_+1,0);
+    std::vector<size_t> c(n);
+    for (size_t j = 0; j < n; ++j)
+      {
+        c[j] = cellOf(x[j],y[j]);
+        ++start_[c[j]+1];
+      }
+    for (size_t k = 0; k < nx_*ny_; ++k) start_[k+1] += start_[k];
+    item_.resize(n);
+    std::vector<size_t> fill(start_.begin(),start_.end()-1);
+    for (size_t j = 0; j < n; ++j) item_[fill[c[j]]++] = j;
+  }
+
+  // The k points nearest to (qx,qy), sorted by increasing distance.
+  void nearest(double qx, double qy, size_t k,
+               std::vector<std::pair<double,size_t> >& out) const
+  {
+    out.clear();
+    const long cx = clampIndex((qx - xmin_)/cell_,nx_);
+    const long cy = clampIndex((qy - ymin_)/cell_,ny_);
+    const long maxr = (long)std::max(nx_,ny_);
+
+    for (long r = 0; r <= maxr; ++r)
+      {
+        addRing(qx,qy,cx,cy,r,out);
+        // Any point not yet seen is at least r cells away.
+        if (out.size() >= k)
+          {
+            std::nth_element(out.begin(),out.begin()+(k-1),out.end());
+            if (out[k-1].first <= r*cell_) break;
+          }
+      }
+    if (out.size() > k)
+      {
+        std::nth_element(out.begin(),out.begin()+(k-1),out.end());
+        out.resize(k);
+      }
+    std::sort(out.begin(),out.end());
+  }
+
+  // The points closer than rad to (qx,qy), in no particular order.
+  void within(double qx, double qy, double rad,
+              std::vector<std::pair<double,size_t> >& out) const
+  {
+    out.clear();
+    const long cx = clampIndex((qx - xmin_)/cell_,nx_);
+    const long cy = clampIndex((qy - ymin_)/cell_,ny_);
+    const long maxr = (long)std::max(nx_,ny_);
+
+    for (long r = 0; r <= maxr && (r-1)*cell_ < rad; ++r)
+      addRing(qx,qy,cx,cy,r,out);
+    size_t m = 0;
+    for (size_t l = 0; l < out.size(); ++l)
+      if (out[l].first < rad) out[m++] = out[l];
+    out.resize(m);
+  }
+
+private:
+  static long clampIndex(double u, size_t n)
+  {
+    long i = (long)std::floor(u);
+    return std::max(0L,std::min((long)n-1,i));
+  }
+
+  // Append the points in the cells at Chebyshev distance r from the
+  // cell (cx,cy), with their distance to (qx,qy).
+  void addRing(double qx, double qy, long cx, long cy, long r,
+               std::vector<std::pair<double,size_t> >& out) const
+  {
+    for (long i = cx-r; i <= cx+r; ++i)
+      {
+        if (i < 0 || i >= (long)nx_) continue;
+        const long step = (r == 0 || i == cx-r || i == cx+r) ? 1 : 2*r;
+        for (long j = cy-r; j <= cy+r; j += step)
+          {
+            if (j < 0 || j >= (long)ny_) continue;
+            const size_t cell = i*ny_ + j;
+            for (size_t m = start_[cell]; m < start_[cell+1]; ++m)
+              {
+                const size_t p = item_[m];
+                const double dx = qx - x_[p], dy = qy - y_[p];
+                out.push_back(std::make_pair(std::sqrt(dx*dx+dy*dy),p));
+              }
+          }
+      }
+  }
+
+  size_t cellOf(double x, double y) const
+  {
+    return clampIndex((x - xmin_)/cell_,nx_)*ny_
+      + clampIndex((y - ymin_)/cell_,ny_);
+  }
+
+  const std::vector<double>& x_;
+  const std::vector<double>& y_;
+  double xmin_, ymin_, cell_;
+  size_t nx_, ny_;
+  std::vector<size_t> start_, item_;
+};
+
+// Minimum-cost assignment of final points (bidders) to initial points
+// (objects) by the auction algorithm, restricted to candidate edges.
+class ClosureAuction
+{
+public:
+  ClosureAuction(const std::vector<double>& x0, const std::vector<double>& y0,
+                 const std::vector<double>& x1, const std::vector<double>& y1,
+                 size_t Nthreads)
+    : x0_(x0), y0_(y0), x1_(x1), y1_(y1), n_(x0.size()), Nthreads_(Nthreads),
+      dense_(false), maxcost_(0), eps_(0)
+  {}
+
+  // Returns the object assigned to each bidder.
+  std::vector<size_t> solve()
+  {
+    if (n_ == 0) return assigned_;
+
+#ifndef BRAIDLAB_NOTHREADING
+    if (Nthreads_ > 1) pool_.reset(new ThreadPool(Nthreads_));
+#endif
+
+    if (n_ > CLOSURE_DENSE)
+      {
+        PointGrid grid0(x0_,y0_), grid1(x1_,y1_);
+        buildCandidates(grid0,grid1,CLOSURE_NCANDIDATES);
+        if (auction(&grid0)) return assigned_;
+        // The optimal matching is not local: give up on the lists.
+      }
+
+    dense_ = true;
+    cand_.clear();
+    maxcost_ = diameter();
+    price_.assign(n_,0);
+    auction(0);
+    return assigned_;
+  }
+
+  double cost() const
+  {
+    double c = 0;
+    for (size_t i = 0; i < n_; ++i) c += dist(i,assigned_[i]);
+    return c;
+  }
+
+private:
+  double dist(size_t i, size_t j) const
+  {
+    double dx = x1_[i] - x0_[j], dy = y1_[i] - y0_[j];
+    return std::sqrt(dx*dx + dy*dy);
+  }
+
+  // An upper bound on all the distances.
+  double diameter() const
+  {
+    double xmin = std::min(*std::min_element(x0_.begin(),x0_.end()),
+                           *std::min_element(x1_.begin(),x1_.end()));
+    double xmax = std::max(*std::max_element(x0_.begin(),x0_.end()),
+                           *std::max_element(x1_.begin(),x1_.end()));
+    double ymin = std::min(*std::min_element(y0_.begin(),y0_.end()),
+                           *std::min_element(y1_.begin(),y1_.end()));
+    double ymax = std::max(*std::max_element(y0_.begin(),y0_.end()),
+                           *std::max_element(y1_.begin(),y1_.end()));
+    return std::sqrt((xmax-xmin)*(xmax-xmin) + (ymax-ymin)*(ymax-ymin));
+  }
+
+  // The k nearest initial points of each final point, the final points
+  // that have it among their k nearest, and the initial point of the
+  // same string.  The latter edges form a perfect matching, so the
+  // sparse problem is always feasible.
+  void buildCandidates(const PointGrid& grid0, const PointGrid& grid1,
+                       size_t k)
+  {
+    cand_.assign(n_,std::vector<std::pair<double,size_t> >());
+    radius_.assign(n_,0);
+    for (size_t i = 0; i < n_; ++i)
+      {
+        grid0.nearest(x1_[i],y1_[i],k,cand_[i]);
+        radius_[i] = cand_[i].back().first;
+        cand_[i].push_back(std::make_pair(dist(i,i),i));
+      }
+    std::vector<std::pair<double,size_t> > near;
+    for (size_t j = 0; j < n_; ++j)
+      {
+        grid1.nearest(x0_[j],y0_[j],k,near);
+        for (size_t m = 0; m < near.size(); ++m)
+          cand_[near[m].second].push_back(std::make_pair(near[m].first,j));
+      }
+    maxcost_ = 0;
+    for (size_t i = 0; i < n_; ++i)
+      {
+        std::sort(cand_[i].begin(),cand_[i].end());
+        cand_[i].erase(std::unique(cand_[i].begin(),cand_[i].end()),
+                       cand_[i].end());
+        maxcost_ = std::max(maxcost_,cand_[i].back().first);
+      }
+    price_.assign(n_,0);
+  }
+
+  // The best object for bidder i, and the price it bids for it.
+  void bid(size_t i, size_t& jbest, double& b) const
+  {
+    double v1 = -std::numeric_limits<double>::infinity(), v2 = v1;
+    jbest = UNASSIGNED;
+    if (dense_)
+      {
+        const double x = x1_[i], y = y1_[i];
+        for (size_t j = 0; j < n_; ++j)
+          {
+            const double dx = x - x0_[j], dy = y - y0_[j];
+            const double v = -std::sqrt(dx*dx + dy*dy) - price_[j];
+            if (v > v1) { v2 = v1; v1 = v; jbest = j; }
+            else if (v > v2) { v2 = v; }
+          }
+      }
+    else
+      {
+        const std::vector<std::pair<double,size_t> >& c = cand_[i];
+        for (size_t m = 0; m < c.size(); ++m)
+          {
+            const double v = -c[m].first - price_[c[m].second];
+            if (v > v1) { v2 = v1; v1 = v; jbest = c[m].second; }
+            else if (v > v2) { v2 = v; }
+          }
+      }
+    // A lone candidate is bid up as if the alternative cost maxcost_
+    // more, which is enough to outbid any rival.
+    if (v2 == -std::numeric_limits<double>::infinity())
+      v2 = v1 - (maxcost_ + eps_);
+    b = price_[jbest] + (v1 - v2) + eps_;
+  }
+
+  // Is it worth computing this many bids in parallel?
+  bool parallelBids(size_t nb) const
+  {
+#ifndef BRAIDLAB_NOTHREADING
+    return (pool_ && nb >= CLOSURE_MINPARALLELBIDDERS);
+#else
+    return false;
+#endif
+  }
+
+  void computeBids(const std::vector<size_t>& bidders,
+                   std::vector<size_t>& obj, std::vector<double>& amt) const
+  {
+    const size_t nb = bidders.size();
+    obj.resize(nb); amt.resize(nb);
+    auto work = [&](size_t lo, size_t hi)
+      { for (size_t m = lo; m < hi; ++m) bid(bidders[m],obj[m],amt[m]); };
+
+#ifndef BRAIDLAB_NOTHREADING
+    if (parallelBids(nb))
+      {
+        std::vector< std::future<void> > done;
+        const size_t chunk = (nb + Nthreads_ - 1) / Nthreads_;
+        for (size_t lo = 0; lo < nb; lo += chunk)
+          done.push_back(pool_->enqueue(work,lo,std::min(nb,lo+chunk)));
+        for (size_t m = 0; m < done.size(); ++m) done[m].get();
+        return;
+      }
+#endif
+    work(0,nb);
+  }
+
+  // Auction with epsilon-scaling.  Each phase starts from the prices
+  // of the previous one, with every bidder unassigned.  For sparse
+  // lists, grid is used to look for better edges that were left out;
+  // returns false if so many are found that the lists are not worth
+  // it.
+  bool auction(const PointGrid *grid)
+  {
+    const double scale = (maxcost_ > 0 ? maxcost_ : 1);
+    const double epsfinal = scale * std::max(1e-10/n_,1e-13);
+    std::vector<size_t> owner, bidders;
+    size_t added = 0;
+
+    eps_ = scale / 2;
+    while (true)
+      {
+        if (bidders.empty())
+          {
+            assigned_.assign(n_,UNASSIGNED);
+            owner.assign(n_,UNASSIGNED);
+            bidders.resize(n_);
+            for (size_t i = 0; i < n_; ++i) bidders[i] = i;
+          }
+        runBidding(bidders,owner);
+
+        if (eps_ > epsfinal)
+          {
+            eps_ = std::max(eps_/CLOSURE_EPSFACTOR,epsfinal);
+            continue;
+          }
+        if (dense_) break;
+
+        // Check epsilon-complementary slackness against the edges that
+        // were left out.  Those that violate it join the candidates.
+        // Only the bidders concerned go back to the auction, since the
+        // others still satisfy the condition, but epsilon restarts at
+        // the size of the worst violation to avoid a price war.
+        const double gap = addViolatingEdges(*grid,bidders,added);
+        if (gap == 0) break;
+        if (added > n_) return false;
+        for (size_t m = 0; m < bidders.size(); ++m)
+          {
+            owner[assigned_[bidders[m]]] = UNASSIGNED;
+            assigned_[bidders[m]] = UNASSIGNED;
+          }
+        eps_ = std::max(gap,epsfinal);
+      }
+    return true;
+  }
+
+  // Bid until every bidder is assigned.
+  void runBidding(std::vector<size_t>& bidders, std::vector<size_t>& owner)
+  {
+    std::vector<size_t> obj, nextbidders, bestbidder(n_);
+    std::vector<double> amt, best(n_);
+
+    // Jacobi rounds: everyone bids at once, in parallel.
+    while (parallelBids(bidders.size()))
+      {
+        computeBids(bidders,obj,amt);
+
+        // Resolve in bidder order, so the outcome does not depend on
+        // the number of threads.
+        nextbidders.clear();
+        for (size_t m = 0; m < bidders.size(); ++m)
+          best[obj[m]] = -std::numeric_limits<double>::infinity();
+        for (size_t m = 0; m < bidders.size(); ++m)
+          {
+            if (amt[m] > best[obj[m]])
+              { best[obj[m]] = amt[m]; bestbidder[obj[m]] = bidders[m]; }
+          }
+        for (size_t m = 0; m < bidders.size(); ++m)
+          {
+            const size_t j = obj[m], i = bidders[m];
+            if (bestbidder[j] != i)
+              { nextbidders.push_back(i); continue; }
+            if (owner[j] != UNASSIGNED)
+              {
+                assigned_[owner[j]] = UNASSIGNED;
+                nextbidders.push_back(owner[j]);
+              }
+            owner[j] = i;
+            assigned_[i] = j;
+            price_[j] = best[j];
+          }
+        bidders.swap(nextbidders);
+      }
+
+    // Gauss-Seidel: the remaining bidders bid one at a time, and the
+    // displaced owners join the end of the queue.
+    for (size_t m = 0; m < bidders.size(); ++m)
+      {
+        const size_t i = bidders[m];
+        size_t j;
+        double b;
+        bid(i,j,b);
+        if (owner[j] != UNASSIGNED)
+          {
+            assigned_[owner[j]] = UNASSIGNED;
+            bidders.push_back(owner[j]);
+          }
+        owner[j] = i;
+        assigned_[i] = j;
+        price_[j] = b;
+      }
+    bidders.clear();
+  }
+
+  // Look for edges outside the candidate lists that violate
+  // epsilon-complementary slackness, and add them.  The bidders
+  // concerned are returned in violators, and the number of edges
+  // added is accumulated in added.  Returns the largest violation, or
+  // 0 if there are none.
+  double addViolatingEdges(const PointGrid& grid,
+                           std::vector<size_t>& violators, size_t& added)
+  {
+    const double pmin = *std::min_element(price_.begin(),price_.end());
+    std::vector<std::pair<double,size_t> > near;
+    double gap = 0;
+    violators.clear();
+    for (size_t i = 0; i < n_; ++i)
+      {
+        const double profit = -dist(i,assigned_[i]) - price_[assigned_[i]];
+        // Only an edge shorter than this can violate the condition, and
+        // none outside the list is shorter than radius_[i].
+        const double dmax = -profit - eps_ - pmin;
+        if (dmax <= radius_[i]) continue;
+        grid.within(x1_[i],y1_[i],dmax,near);
+        bool violated = false;
+        for (size_t m = 0; m < near.size(); ++m)
+          {
+            const double d = near[m].first;
+            const size_t j = near[m].second;
+            const double excess = -d - price_[j] - (profit + eps_);
+            if (excess <= 0) continue;
+            bool listed = false;
+            for (size_t l = 0; l < cand_[i].size() && !listed; ++l)
+              listed = (cand_[i][l].second == j);
+            if (listed) continue;
+            cand_[i].push_back(std::make_pair(d,j));
+            maxcost_ = std::max(maxcost_,d);
+            gap = std::max(gap,excess);
+            violated = true;
+            ++added;
+          }
+        if (violated) violators.push_back(i);
+      }
+    return gap;
+  }
+
+  const std::vector<double> &x0_, &y0_, &x1_, &y1_;
+  const size_t n_;
+  const size_t Nthreads_;
+
+  // In dense mode every initial point is a candidate, and distances are
+  // computed as needed rather than stored.
+  bool dense_;
+  std::vector< std::vector<std::pair<double,size_t> > > cand_;
+  std::vector<double> radius_;
+  std::vector<double> price_;
+  std::vector<size_t> assigned_;
+  double maxcost_;
+  double eps_;
+
+#ifndef BRAIDLAB_NOTHREADING
+  std::unique_ptr<ThreadPool> pool_;
+#endif
+};
+
+template <typename T>
+void closeTrajectories(const mxArray *XY, const std::vector<size_t>& perm,
+                       mxArray *XYc)
+{
+  const mwSize *dims = mxGetDimensions(XY);
+  const size_t nT = dims[0], n = perm.size();
+  const T *in = static_cast<const T*>(mxGetData(XY));
+  T *out = static_cast<T*>(mxGetData(XYc));
+
+  for (size_t s = 0; s < n; ++s)
+    for (size_t c = 0; c < 2; ++c)
+      {
+        const T *col = in + (s*2 + c)*nT;
+        T *ocol = out + (s*2 + c)*(nT+1);
+        std::copy(col,col+nT,ocol);
+        // Append the initial point of the matched string.
+        ocol[nT] = in[(perm[s]*2 + c)*nT];
+      }
+}
+
+template <typename T>
+void readEndpoints(const mxArray *XY,
+                   std::vector<double>& x0, std::vector<double>& y0,
+                   std::vector<double>& x1, std::vector<double>& y1)
+{
+  const mwSize *dims = mxGetDimensions(XY);
+  const size_t nT = dims[0];
+  const size_t n = (mxGetNumberOfDimensions(XY) > 2 ? dims[2] : 1);
+  const T *in = static_cast<const T*>(mxGetData(XY));
+
+  x0.resize(n); y0.resize(n); x1.resize(n); y1.resize(n);
+  for (size_t s = 0; s < n; ++s)
+    {
+      x0[s] = in[(s*2)*nT];       y0[s] = in[(s*2+1)*nT];
+      x1[s] = in[(s*2)*nT + nT-1]; y1[s] = in[(s*2+1)*nT + nT-1];
+    }
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  if (nrhs < 1)
+    mexErrMsgIdAndTxt("BRAIDLAB:closure_helper:badarg",
+                      "Not enough input arguments.");
+
+  if (!mxIsDouble(p_XY) && !mxIsSingle(p_XY))
+    mexErrMsgIdAndTxt("BRAIDLAB:closure_helper:badarg",
+                      "XY must be of class double or single.");
+
+  const mwSize *dims = mxGetDimensions(p_XY);
+  if (mxGetNumberOfDimensions(p_XY) > 3 || dims[1] != 2 || dims[0] < 1)
+    mexErrMsgIdAndTxt("BRAIDLAB:closure_helper:badarg",
+                      "XY must be a nT x 2 x n array.");
+
+  size_t Nthreads = 1;
+  if (nrhs > 1 && !mxIsEmpty(p_Nthreads))
+    Nthreads = std::max(1.0,mxGetScalar(p_Nthreads));
+
+  std::vector<double> x0, y0, x1, y1;
+  if (mxIsSingle(p_XY))
+    readEndpoints<float>(p_XY,x0,y0,x1,y1);
+  else
+    readEndpoints<double>(p_XY,x0,y0,x1,y1);
+  const size_t n = x0.size();
+
+  ClosureAuction A(x0,y0,x1,y1,Nthreads);
+  std::vector<size_t> perm = A.solve();
+
+  plhs[0] = mxCreateDoubleMatrix(1,n,mxREAL);
+  double *pperm = mxGetPr(plhs[0]);
+  for (size_t i = 0; i < n; ++i) pperm[i] = perm[i] + 1;
+
+  if (nlhs > 1)
+    {
+      mwSize cdims[3] = {dims[0]+1, 2, n};
+      plhs[1] = mxCreateNumericArray(3,cdims,mxGetClassID(p_XY),mxREAL);
+      if (mxIsSingle(p_XY))
+        closeTrajectories<float>(p_XY,perm,plhs[1]);
+      else
+        closeTrajectories<double>(p_XY,perm,plhs[1]);
+    }
+
+  if (nlhs > 2)
+    plhs[2] = mxCreateDoubleScalar(A.cost());
+}
@@ -0,0 +1,31 @@
+function varargout = closure_helper(varargin)
+%CLOSURE_HELPER   See closure_helper.cpp.
+%
+%   This M-file is invoked only when the corresponding MEX function
+%   does not exist.
+
+% <LICENSE
+%   Braidlab: a Matlab package for analyzing data using braids
+%
+%   https://github.com/jeanluct/braidlab
+%
+%   Copyright (C) 2013-2026  Jean-Luc Thiffeault <jeanluc@math.wisc.edu>
+%                            Marko Budisic          <mbudisic@gmail.com>
+%
+%   This file is part of Braidlab.
+%
+%   Braidlab is free software: you can redistribute it and/or modify
+%   it under the terms of the GNU General Public License as published by
+%   the Free Software Foundation, either version 3 of the License, or
+%   (at your option) any later version.
+%
+%   Braidlab is distributed in the hope that it will be useful,
+%   but WITHOUT ANY WARRANTY; without even the implied warranty of
+%   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+%   GNU General Public License for more details.
+%
+%   You should have received a copy of the GNU General Public License
+%   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
+% LICENSE>
+
+throwAsCaller(braidlab.util.NoMEXException(mfilename));
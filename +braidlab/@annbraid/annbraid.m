@@ -211,13 +211,13 @@ classdef annbraid < braidlab.braid
       m = burau@braidlab.braid(b.braid,varargin{:});
     end
 
-    function c = compact(b)
+    function c = compact(b,varargin)
       ; %#ok<NOSEM>
       % Do not put comments above the first line of code, so the help
       % message from braid superclass is displayed.
 
       % Note here we do *not* convert to a braidlab.braid first.
-      bc = compact@braidlab.braid(b,true);
+      bc = compact@braidlab.braid(b,true,varargin{:});
       c = braidlab.annbraid(bc.word,b.nann);
     end
 
@@ -253,6 +253,16 @@ classdef annbraid < braidlab.braid
       [varargout{1:nargout}] = entropy@braidlab.braid(b.braid,varargin{:});
     end
 
+    function [c,layers] = foata(b)
+      ; %#ok<NOSEM>
+      % Do not put comments above the first line of code, so the help
+      % message from braid superclass is displayed.
+
+      % Generators 1 and n-1 of the annular braid do not commute.
+      [bc,layers] = foata@braidlab.braid(b,true);
+      c = braidlab.annbraid(bc.word,b.nann);
+    end
+
     function l = loopcoords(b,varargin)
       ; %#ok<NOSEM>
       % Do not put comments above the first line of code, so the help
@@ -302,6 +312,12 @@ classdef annbraid < braidlab.braid
       error('BRAIDLAB:annbraid:subbraid:undefined',...
             'This operation is not yet implemented for annbraids.')
     end
+
+    % This could be implemented.
+    function linkmatrix(varargin)
+      error('BRAIDLAB:annbraid:linkmatrix:undefined',...
+            'This operation is not yet implemented for annbraids.')
+    end
   end % methods block
 
 end % annbraid classdef
@@ -349,13 +349,14 @@ classdef braid < matlab.mixin.CustomDisplay
     %EQ   Test braids for equality.
     %   EQ(B1,B2) or B1==B2 returns TRUE if the two braids B1 and B2 are
     %   equal.  The algorithm uses Dynnikov coordinates (action on loops) to
-    %   determine braid equalitty.
+    %   determine braid equalitty.  If these overflow, B1*B2^-1 is tested
+    %   for triviality by handle reduction instead (see BRAID.ISTRIVIAL).
     %
     %   Reference: P. Dehornoy, "Efficient solutions to the braid isotopy
     %   problem," Discrete Applied Mathematics 156 (2008), 3091-3112.
     %
     %   This is a method for the BRAID class.
-    %   See also BRAID, BRAID.LEXEQ, LOOP, LOOPCOORDS.
+    %   See also BRAID, BRAID.LEXEQ, BRAID.ISTRIVIAL, LOOP, LOOPCOORDS.
       ee = b1.n == b2.n; if ~ee, return; end
       if isempty(b1.word)
         if isempty(b2.word)
@@ -364,7 +365,14 @@ classdef braid < matlab.mixin.CustomDisplay
         end
       end
       % Check if the loop coordinates are the same.
-      ee = all(loopcoords(b1) == loopcoords(b2));
+      try
+        ee = all(loopcoords(b1,@int64) == loopcoords(b2,@int64));
+      catch err
+        if ~strcmp(err.identifier,'BRAIDLAB:braid:sumg:overflow')
+          rethrow(err)
+        end
+        ee = istrivial(braidlab.braid(b1)*inv(braidlab.braid(b2)));
+      end
     end
 
     function ee = lexeq(b1,b2)
@@ -389,11 +397,36 @@ classdef braid < matlab.mixin.CustomDisplay
 
     function ee = istrivial(b)
     %ISTRIVIAL   Return true if braid is the trivial braid.
+    %   The loop coordinates of the braid are compared to those of the
+    %   trivial braid.  For long braids these can overflow, and the braid
+    %   word is then reduced by Dehornoy's handle reduction: it is trivial
+    %   if and only if it reduces to the empty word.  This is much faster
+    %   than computing the loop coordinates with VPI.
+    %
+    %   Reference: P. Dehornoy, "A fast method for comparing braids,"
+    %   Advances in Math. 125 (1997), 200-235.
     %
     %   This is a method for the BRAID class.
-    %   See also BRAID, BRAID.EQ.
+    %   See also BRAID, BRAID.EQ, BRAID.COMPACT.
       if isempty(b.word), ee = true; return; end
-      ee = all(loopcoords(b) == loopcoords(braidlab.braid([],b.n)));
+      try
+        l = loopcoords(b,@int64);
+      catch err
+        if ~strcmp(err.identifier,'BRAIDLAB:braid:sumg:overflow')
+          rethrow(err)
+        end
+        try
+          % annbraid words need to be converted first.
+          bb = braidlab.braid(b);
+          ee = isempty(compact_helper(bb.word,bb.n,false,1,2));
+          return
+        catch err
+          if ~strcmp(err.identifier,'BRAIDLAB:NoMEX'), rethrow(err); end
+        end
+        % No MEX file: fall back to VPI.
+        l = loopcoords(b);
+      end
+      ee = all(l == loopcoords(braidlab.braid([],b.n)));
     end
 
     function ee = ispure(obj)
@@ -527,6 +560,10 @@ classdef braid < matlab.mixin.CustomDisplay
   % Need to execute 'clear classes' to register changes here.
   %
 
+  methods (Static = true)
+    [b,tcr,prof] = multiproj(XY,proj,t)
+  end % methods block
+
   % The subclass databraid has access to colorbraiding.
   methods (Static = true, Access = {?braidlab.databraid})
     [varargout] = colorbraiding(XY,t,proj,checkclosure)
@@ -10,9 +10,25 @@ function [varargout] = colorbraiding(XY,t,proj,checkclosure)
 %
 %   [B,TCR] = COLORBRAIDING(XY,T) also returns the time of crossing (TCR).
 %
+%   [B,TCR,PROF] = COLORBRAIDING(XY,T) also returns a profile of the C++
+%   version of the algorithm, to help choose the number of threads.  PROF
+%   is a struct with fields WALL and CPU (structs of the wall-clock and
+%   CPU times, in msec, of the phases DETECTION, SORT, BLOCKS and OUTPUT),
+%   THREADS (number of threads used for crossing detection), CROSSINGS
+%   (number of pairwise crossings), BLOCKSIZES (BLOCKSIZES(K) is the
+%   number of blocks of K concurrent crossings) and THREADTASKS (number of
+%   detection tasks run by each thread).  CPU time is summed over all
+%   threads.  PROF is empty if the MATLAB version is used.
+%
 %   The projection line angle PROJANG can be specified as an optional
 %   third argument (default 0).
 %
+%   If PROJANG is a vector of angles, B is a row array of braids, one for
+%   each projection angle, and TCR is a cell array of crossing times.  The
+%   C++ version then computes all the braids in a single pass over the
+%   data, rotating the coordinates on the fly rather than making a rotated
+%   copy of XY for each angle.
+%
 %   When two strands project onto the same point at any time instance, it
 %   is not generally possible to robustly determine their identities. In
 %   such events, the function issues the error
@@ -21,6 +37,15 @@ function [varargout] = colorbraiding(XY,t,proj,checkclosure)
 %   either change the PROJANG parameter or reduce the value of the braidlab
 %   parameter BraidAbsTol using braidlab.prop('BraidAbsTol', VALUE) command.
 %
+%   The generators can be reduced as they are found, by cancelling
+%   back-and-forth crossings, using the braidlab property BraidReduce (see
+%   BRAIDLAB.PROP).  The surviving generators keep their crossing times
+%   TCR.
+%
+%   The trajectory data XY may be of class single, in which case it is
+%   processed without conversion to double (halving memory use for large
+%   data sets).  The crossing times TCR are always of class double.
+%
 %   COLORBRAIDING is a protected static method of the BRAID class.  It
 %   is also used by the DATABRAID subclass.
 %
@@ -86,11 +111,17 @@ validateattributes(XY,{'numeric'},...
                    'BRAIDLAB.braid.colorbraiding','XY',1 );
 
 validateattributes(proj,{'numeric'},...
-                   {'real','finite','scalar','nonnan','nonempty'},...
+                   {'real','finite','vector','nonnan','nonempty'},...
                    'BRAIDLAB.braid.colorbraiding','proj',3 );
 
 debugmsg('colorbraiding: Initialize parameters for crossing analysis',2);
 tic
+
+% Single-precision data is passed as is to the MEX file, which reads it
+% in place; any other numeric class is promoted to double.  Crossing
+% times are always computed in double precision.
+if ~isfloat(XY), XY = double(XY); end
+t = double(t);
 n = size(XY,3); % number of punctures
 
 if nargin < 3
@@ -99,17 +130,29 @@ if nargin < 3
 end
 
 delta = braidlab.prop('BraidAbsTol');
+% Online reduction of the generators: 0 (none), 1 (cancel), 2 (commute).
+reduce = find(strcmpi(braidlab.prop('BraidReduce'), ...
+                      {'none','cancel','commute'})) - 1;
 
-% Rotate coordinates according to angle proj.  Note that since the
-% projection line is supposed to be rotated counterclockwise by proj, we
-% rotate the data clockwise by proj.
-if proj ~= 0, XY = rotate_data_clockwise(XY,proj); end
+multiproj = ~isscalar(proj);
 
-% Sort the initial conditions from left to right according to their initial
-% X coord; IDX contains the indices of the sort.
-[~,idx] = sortrows(squeeze(XY(1,:,:)).');
-% Sort all the trajectories trajectories according to IDX:
-XY = XY(:,:,idx);
+if multiproj
+  % Each projection angle is rotated and sorted separately, and errors
+  % refer to the original particle indices.
+  proj = double(proj(:).');
+  idx = 1:n;
+else
+  % Rotate coordinates according to angle proj.  Note that since the
+  % projection line is supposed to be rotated counterclockwise by proj, we
+  % rotate the data clockwise by proj.
+  if proj ~= 0, XY = rotate_data_clockwise(XY,proj); end
+
+  % Sort the initial conditions from left to right according to their
+  % initial X coord; IDX contains the indices of the sort.
+  [~,idx] = sortrows(squeeze(XY(1,:,:)).');
+  % Sort all the trajectories trajectories according to IDX:
+  XY = XY(:,:,idx);
+end
 
 if checkclosure
   % Check if the final points are close enough to the initial points (setwise).
@@ -117,18 +160,26 @@ if checkclosure
   % Suggest user call 'closure(XY)' first.
 
   % Use optimal assignment to match the ends.
-  % This piece of code is basically pasted from closure.m.
   XY0 = squeeze(XY(1,:,:));
-  XY1 = sortrows(squeeze(XY(end,:,:))')';
-  % Create matrix of distances.
-  D = zeros(n,n);
-  for i = 1:n
-    for j = 1:n
-      D(i,j) = norm(XY1(:,i)-XY0(:,j));
+  XY1 = squeeze(XY(end,:,:));
+  try
+    assert(~useMatlabVersion, 'BRAIDLAB:NoMEX', 'Matlab version forced');
+    perm = braidlab.util.closure_helper(XY,getAvailableThreadNumber());
+  catch me
+    if isempty(regexpi(me.identifier, 'BRAIDLAB:NoMEX', 'once'))
+      rethrow(me);
     end
+    % This piece of code is basically pasted from closure.m.
+    % Create matrix of distances.
+    D = zeros(n,n);
+    for i = 1:n
+      for j = 1:n
+        D(i,j) = norm(XY1(:,i)-XY0(:,j));
+      end
+    end
+    % Solve the optimal assignment problem.
+    perm = braidlab.util.assignmentoptimal(D);
   end
-  % Solve the optimal assignment problem.
-  perm = braidlab.util.assignmentoptimal(D);
 
   if any(sqrt(sum((XY0(:,perm) - XY1).^2,1)) > delta)
     warning('BRAIDLAB:braid:colorbraiding:notclosed',...
@@ -152,7 +203,14 @@ try % trapping to ensure proper identification of strands
 
     %% C++ version of the algorithm
     Nthreads = getAvailableThreadNumber(); % defined at the end
-    [gen,tcr] = cross2gen_helper(XY,t,delta,Nthreads);
+    args = {XY,t,delta,Nthreads,[],reduce};
+    if multiproj, args{5} = proj; end
+    % The profile is only collected if it is requested.
+    if nargout > 2
+      [gen,tcr,prof] = cross2gen_helper(args{:});
+    else
+      [gen,tcr] = cross2gen_helper(args{:});
+    end
 
   catch me
     if isempty( regexpi(me.identifier, 'BRAIDLAB:NoMEX', 'once') )
@@ -160,14 +218,32 @@ try % trapping to ensure proper identification of strands
     else
     debugmsg('Using MATLAB algorithm',2)
       %% MATLAB version of the algorithm
-      [gen,tcr,~] = cross2gen(XY,t,delta);
+      if multiproj
+        [gen,tcr] = cross2gen_multiproj(XY,t,delta,proj);
+        for k = 1:numel(proj)
+          [gen{k},tcr{k}] = reduce_generators(gen{k},tcr{k},reduce,n);
+        end
+      else
+        [gen,tcr,~] = cross2gen(XY,t,delta);
+        [gen,tcr] = reduce_generators(gen,tcr,reduce,n);
+      end
+      prof = struct([]);
     end
   end
 
 catch me
 
   % Identify particles causing the error using IDX vector
-  % and re-throw the error with appropriate reporting
+  % and re-throw the error with appropriate reporting.  With several
+  % projection angles, the message also ends with the index of the angle.
+  angmsg = '';
+  if multiproj
+    k = regexp(me.message,'projection angle (\d+)\)','tokens','once');
+    if ~isempty(k)
+      k = str2double(k{1});
+      angmsg = sprintf(' for projection angle %g (number %d)',proj(k),k);
+    end
+  end
   switch(me.identifier)
     case 'BRAIDLAB:braid:colorbraiding:coincidentparticles'
 
@@ -177,8 +253,8 @@ catch me
       sortedPair = idx(localPair);
 
       error(me.identifier, ...
-            ['Paths of particles %d and %d intersect.  The braid cannot' ...
-             ' be formed.'],sortedPair(1),sortedPair(2));
+            ['Paths of particles %d and %d intersect%s.  The braid cannot' ...
+             ' be formed.'],sortedPair(1),sortedPair(2),angmsg);
 
     case 'BRAIDLAB:braid:colorbraiding:coincidentprojection'
 
@@ -188,13 +264,90 @@ catch me
       sortedPair = idx(localPair);
 
       error(me.identifier, ...
-            ['Paths of particles %d and %d have a coincident projection.' ...
-             '  Try changing the projection angle.'], ...
-            sortedPair(1),sortedPair(2));
+            ['Paths of particles %d and %d have a coincident projection' ...
+             '%s.  Try changing the projection angle.'], ...
+            sortedPair(1),sortedPair(2),angmsg);
     otherwise
       rethrow(me)
   end
 end
 
-varargout{1} = braidlab.braid(gen,n);
+if multiproj
+  b = braidlab.braid.empty(1,0);
+  for k = 1:numel(proj), b(k) = braidlab.braid(gen{k},n); end
+  varargout{1} = b;
+else
+  varargout{1} = braidlab.braid(gen,n);
+end
 if nargout > 1, varargout{2} = tcr; end
+if nargout > 2, varargout{3} = prof; end
+
+% =========================================================================
+function [gen,tcr] = cross2gen_multiproj(XY,t,delta,proj)
+%CROSS2GEN_MULTIPROJ   MATLAB version of CROSS2GEN_HELPER for several angles.
+%   Loops over the projection angles PROJ, rotating and sorting the data
+%   for each one.  Errors refer to the original (unsorted) particles, and
+%   end with the index of the angle, as in CROSS2GEN_HELPER.
+
+gen = cell(1,numel(proj));
+tcr = cell(1,numel(proj));
+
+for k = 1:numel(proj)
+  XYk = XY;
+  if proj(k) ~= 0, XYk = rotate_data_clockwise(XY,proj(k)); end
+  [~,idk] = sortrows(squeeze(XYk(1,:,:)).');
+  try
+    [gen{k},tcr{k},~] = cross2gen(XYk(:,:,idk),t,delta);
+  catch me
+    switch(me.identifier)
+      case {'BRAIDLAB:braid:colorbraiding:coincidentparticles', ...
+            'BRAIDLAB:braid:colorbraiding:coincidentprojection'}
+        localPair = eval(strtok(me.message,'|'));
+        error(me.identifier,'%s | (projection angle %d)', ...
+              mat2str(idk(localPair(:)).'),k);
+      otherwise
+        rethrow(me)
+    end
+  end
+end
+
+% =========================================================================
+function [gen,tcr] = reduce_generators(gen,tcr,reduce,n)
+%REDUCE_GENERATORS   MATLAB version of the reduction in CROSS2GEN_HELPER.
+%   Cancel each generator with the one just before it (REDUCE=1), or with
+%   the last one before it that it doesn't commute with (REDUCE=2), if
+%   that is its inverse.  The surviving generators keep their times.
+
+if reduce == 0 || isempty(gen), return; end
+
+keep = false(size(gen));
+if reduce == 1
+  % Stack of the positions of the surviving generators.
+  st = zeros(size(gen)); top = 0;
+  for i = 1:numel(gen)
+    if top > 0 && gen(st(top)) == -gen(i)
+      keep(st(top)) = false; top = top-1;
+    else
+      top = top+1; st(top) = i; keep(i) = true;
+    end
+  end
+else
+  % Positions of the surviving generators of each index.
+  st = cell(1,n);
+  for i = 1:numel(gen)
+    g = abs(gen(i));
+    last = 0; lastg = 0;
+    for h = max(g-1,1):min(g+1,n)
+      if ~isempty(st{h}) && st{h}(end) > last
+        last = st{h}(end); lastg = h;
+      end
+    end
+    if lastg == g && gen(last) == -gen(i)
+      keep(last) = false; st{g}(end) = [];
+    else
+      keep(i) = true; st{g}(end+1) = i;
+    end
+  end
+end
+gen = gen(keep);
+tcr = tcr(keep);
@@ -1,4 +1,4 @@
-function c = compact(b,annular)
+function c = compact(b,varargin)
 %COMPACT   Try to shorten a braid by cancelling generators.
 %   C = COMPACT(B) attempts to shorten a braid B by using group properties,
 %   and returns the shortened braid C.  The group relations are
@@ -13,6 +13,25 @@ function c = compact(b,annular)
 %   co-NP-complete problem (Ref. [1]).  But it uses the algorithm in
 %   Ref. [2] which is known to do pretty well at shortening braids.
 %
+%   C = COMPACT(B,'Parallel') is faster for long braids (more than 32768
+%   generators): the word is cut into segments that are compacted in
+%   parallel and then joined, only revisiting the generators near the
+%   seams.  The result can differ from that of COMPACT(B), and is not
+%   guaranteed to be as short, but for random braids it has about the
+%   same length (within 1%).  It does not depend on the number of
+%   threads, which can be set with the global MATLAB variable
+%   BRAIDLAB_threads.
+%
+%   C = COMPACT(B,'Foata') is a much faster mode that only uses the
+%   commutation relation (and cancellation of a generator and its inverse),
+%   in a single linear-time pass.  C is then the Cartier-Foata normal form
+%   of B (see BRAID.FOATA).
+%
+%   C = COMPACT(B,'Handle') also applies Dehornoy's handle reduction
+%   (Ref. [3]) to B, compacts the result, and returns it if it is shorter.
+%   This is slower but finds more cancellations: in particular, C is
+%   always the empty word if B is trivial.
+%
 %   References
 %
 %   [1] M. S. Paterson and A. A. Razborov, "The set of minimal braids is
@@ -21,8 +40,11 @@ function c = compact(b,annular)
 %   [2] P. D. Bangert, M. A. Berger and R. Prandi, "In search of minimal
 %   random braid configurations," J. Phys. A 35 (2002), 43-59.
 %
+%   [3] P. Dehornoy, "A fast method for comparing braids," Advances in
+%   Math. 125 (1997), 200-235.
+%
 %   This is a method for the BRAID class.
-%   See also BRAID.
+%   See also BRAID, BRAID.FOATA.
 
 % <LICENSE
 %   Braidlab: a Matlab package for analyzing data using braids
@@ -58,10 +80,33 @@ function c = compact(b,annular)
 %  return;
 %end
 
+% annular = true means an annular braid.
+annular = false; mode = 0; parallel = false;
+for k = 1:length(varargin)
+  if ischar(varargin{k}) && strcmpi(varargin{k},'foata')
+    mode = 1;
+  elseif ischar(varargin{k}) && strcmpi(varargin{k},'handle')
+    mode = 3;
+  elseif ischar(varargin{k}) && strcmpi(varargin{k},'parallel')
+    parallel = true;
+  elseif islogical(varargin{k}) && isscalar(varargin{k})
+    annular = varargin{k};
+  else
+    error('BRAIDLAB:braid:compact:badarg','Unrecognized option.')
+  end
+end
+
+if annular && mode == 3
+  error('BRAIDLAB:braid:compact:badarg', ...
+        'Handle reduction is not implemented for annular braids.')
+end
+
+% The number of threads for parallel compaction (0 for serial).
+Nthreads = 0;
+if parallel, Nthreads = braidlab.util.getAvailableThreadNumber(); end
+
 if ~isempty(b.word) && length(b) > 1
-  % annular = true means an annular braid.
-  if nargin < 2, annular = false; end
-  bc = compact_helper(b.word,b.n,annular);
+  bc = compact_helper(b.word,b.n,annular,Nthreads,mode);
 else
   bc = b.word;
 end
@@ -1,4 +1,4 @@
-function [varargout] = conjtest(b1,b2)
+function [varargout] = conjtest(b1,b2,varargin)
 %CONJTEST   Conjugacy test for braids.
 %   ISCONJ = CONJTEST(B1,B2) returns true if B1 and B2 are conjugate
 %   braids, that is, if there exists a braid C such that
@@ -7,7 +7,12 @@ function [varargout] = conjtest(b1,b2)
 %
 %   [ISCONJ,C] = CONJTEST(B1,B2) also returns the conjugating braid C.
 %
-%   See also CFBRAID.
+%   CONJTEST(B1,B2,METHOD) chooses the algorithm: 'uss' searches the
+%   Ultra Summit Set, 'sc' the set of sliding circuits, 'bkl' the super
+%   summit set in band generators, and 'auto' picks one of the first
+%   two.  See CFBRAID.CONJTEST for the default.
+%
+%   See also CFBRAID, CFBRAID.CONJTEST.
 
 % <LICENSE
 %   Braidlab: a Matlab package for analyzing data using braids
@@ -33,7 +38,12 @@ function [varargout] = conjtest(b1,b2)
 %   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
 % LICENSE>
 
-[isconj,C] = conjtest(braidlab.cfbraid(b1),braidlab.cfbraid(b2));
+if nargout > 1
+  [isconj,C] = conjtest(braidlab.cfbraid(b1),braidlab.cfbraid(b2), ...
+                        varargin{:});
+else
+  isconj = conjtest(braidlab.cfbraid(b1),braidlab.cfbraid(b2),varargin{:});
+end
 
 varargout{1} = isconj;
 if nargout > 1
@@ -0,0 +1,62 @@
+function [c,layers] = foata(b,annular)
+%FOATA   Cartier-Foata normal form of a braid word.
+%   C = FOATA(B) returns the braid B written in Cartier-Foata normal form.
+%   The word of C is a product of layers of generators that commute with
+%   each other, sorted by index within each layer, and each generator is
+%   in the layer just after the last generator before it that it doesn't
+%   commute with.  A generator that would follow its inverse in this form
+%   is cancelled with it.  The normal form is found in a single pass over
+%   the word, in a time proportional to its length.
+%
+%   [C,LAYERS] = FOATA(B) also returns the number of generators in each
+%   layer, so that SUM(LAYERS) is the length of C.  LENGTH(LAYERS) is the
+%   depth of the braid word, i.e., the minimum number of steps needed if
+%   commuting generators are applied at the same time.
+%
+%   Two braids whose words only differ by commutations of generators and by
+%   insertion or deletion of a generator and its inverse have the same
+%   normal form.  For such braids LEXEQ(FOATA(B1),FOATA(B2)) is a cheap
+%   substitute for B1 == B2, and the word of FOATA(B) can be used as a key
+%   to hash braids, for instance with MAT2STR.  Braids that are only equal
+%   through the relation S(i) S(i+1) S(i) = S(i+1) S(i) S(i+1) can have
+%   different normal forms.
+%
+%   This is a method for the BRAID class.
+%   See also BRAID, BRAID.COMPACT, BRAID.LEXEQ.
+
+% <LICENSE
+%   Braidlab: a Matlab package for analyzing data using braids
+%
+%   https://github.com/jeanluct/braidlab
+%
+%   Copyright (C) 2013-2026  Jean-Luc Thiffeault <jeanluc@math.wisc.edu>
+%                            Marko Budisic          <mbudisic@gmail.com>
+%
+%   This file is part of Braidlab.
+%
+%   Braidlab is free software: you can redistribute it and/or modify
+%   it under the terms of the GNU General Public License as published by
+%   the Free Software Foundation, either version 3 of the License, or
+%   (at your option) any later version.
+%
+%   Braidlab is distributed in the hope that it will be useful,
+%   but WITHOUT ANY WARRANTY; without even the implied warranty of
+%   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+%   GNU General Public License for more details.
+%
+%   You should have received a copy of the GNU General Public License
+%   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
+% LICENSE>
+
+% annular = true means an annular braid: generators 1 and n-1 then do not
+% commute.
+if nargin < 2, annular = false; end
+
+if ~isempty(b.word)
+  [bc,layers] = compact_helper(b.word,b.n,logical(annular),1,1);
+else
+  bc = b.word;
+  layers = zeros(1,0);
+end
+
+c = braidlab.braid(bc,b.n);
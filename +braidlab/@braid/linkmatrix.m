@@ -0,0 +1,66 @@
+function W = linkmatrix(b)
+%LINKMATRIX   Matrix of signed crossings between pairs of strings.
+%   W = LINKMATRIX(B) returns the symmetric N by N matrix W, where N is the
+%   number of strings of the braid B, such that W(I,J) is the sum of the
+%   signs of the crossings of strings I and J.  Strings are labelled by
+%   their initial position.  W(I,J) is the writhe of SUBBRAID(B,[I J]),
+%   but the whole matrix is computed in a single pass over the braid word,
+%   split between threads for long braids.
+%
+%   For a pure braid, W/2 is the matrix of winding (linking) numbers of
+%   pairs of strings.  For the closure of a braid, the linking number of
+%   two components is half the sum of W(I,J) over the strings I of one
+%   component and J of the other.
+%
+%   This is a method for the BRAID class.
+%   See also BRAID, BRAID.SUBBRAID, BRAID.WRITHE.
+
+% <LICENSE
+%   Braidlab: a Matlab package for analyzing data using braids
+%
+%   https://github.com/jeanluct/braidlab
+%
+%   Copyright (C) 2013-2026  Jean-Luc Thiffeault <jeanluc@math.wisc.edu>
+%                            Marko Budisic          <mbudisic@gmail.com>
+%
+%   This file is part of Braidlab.
+%
+%   Braidlab is free software: you can redistribute it and/or modify
+%   it under the terms of the GNU General Public License as published by
+%   the Free Software Foundation, either version 3 of the License, or
+%   (at your option) any later version.
+%
+%   Braidlab is distributed in the hope that it will be useful,
+%   but WITHOUT ANY WARRANTY; without even the implied warranty of
+%   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+%   GNU General Public License for more details.
+%
+%   You should have received a copy of the GNU General Public License
+%   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
+% LICENSE>
+
+%% determine if MEX implementation should be used
+global BRAIDLAB_braid_nomex %#ok<GVMIS>
+usematlab = ~(isempty(BRAIDLAB_braid_nomex) || ~BRAIDLAB_braid_nomex);
+
+if ~usematlab
+  try
+    W = linkmatrix_helper(b.word,b.n, ...
+                          braidlab.util.getAvailableThreadNumber());
+  catch me
+    warning(me.identifier, [ me.message ...
+                    ' Reverting to Matlab linkmatrix'] );
+    usematlab = true;
+  end
+end
+
+if usematlab
+  W = zeros(b.n);
+  p = 1:b.n;
+  for gen = b.word
+    i = abs(gen);
+    W(p(i),p(i+1)) = W(p(i),p(i+1)) + sign(gen);
+    p([i i+1]) = p([i+1 i]);
+  end
+  W = W + W.';
+end
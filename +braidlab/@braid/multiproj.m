@@ -0,0 +1,70 @@
+function [b,tcr,prof] = multiproj(XY,proj,t)
+%MULTIPROJ   Braids from trajectories for several projection angles.
+%   B = BRAID.MULTIPROJ(XY,PROJANG) returns a row array of braids B, where
+%   B(K) is the braid BRAID(XY,PROJANG(K)) for the trajectory dataset XY
+%   and the projection line angle PROJANG(K) (in radians).  The data
+%   format is XY(1:NSTEPS,1:2,1:N), or a complex array XY(1:NSTEPS,1:N).
+%
+%   [B,TCR] = BRAID.MULTIPROJ(XY,PROJANG,T) specifies the times T of the
+%   datapoints (default 1:NSTEPS), and also returns a cell array TCR of
+%   crossing times, so that DATABRAID(B(K),TCR{K}) is the databraid for
+%   projection angle PROJANG(K).
+%
+%   [B,TCR,PROF] = BRAID.MULTIPROJ(XY,PROJANG,T) also returns a struct
+%   PROF with the wall-clock and CPU times of the phases of the
+%   computation, and statistics for choosing the number of threads.  See
+%   the help of BRAID.COLORBRAIDING for its fields.
+%
+%   This is much faster than calling BRAID for each angle, since the
+%   braids are all computed in a single pass over the data, without
+%   making a rotated copy of XY for each angle.  This is useful for
+%   checking the robustness of a braid with respect to the projection.
+%
+%   This is a static method for the BRAID class.
+%   See also BRAID, BRAID.BRAID, DATABRAID.DATABRAID.
+
+% <LICENSE
+%   Braidlab: a Matlab package for analyzing data using braids
+%
+%   https://github.com/jeanluct/braidlab
+%
+%   Copyright (C) 2013-2026  Jean-Luc Thiffeault <jeanluc@math.wisc.edu>
+%                            Marko Budisic          <mbudisic@gmail.com>
+%
+%   This file is part of Braidlab.
+%
+%   Braidlab is free software: you can redistribute it and/or modify
+%   it under the terms of the GNU General Public License as published by
+%   the Free Software Foundation, either version 3 of the License, or
+%   (at your option) any later version.
+%
+%   Braidlab is distributed in the hope that it will be useful,
+%   but WITHOUT ANY WARRANTY; without even the implied warranty of
+%   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+%   GNU General Public License for more details.
+%
+%   You should have received a copy of the GNU General Public License
+%   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
+% LICENSE>
+
+if ismatrix(XY) && ~isreal(XY)
+  % Complex data: convert to XY(1:NSTEPS,1:2,1:N).
+  XY = reshape([real(XY);imag(XY)], [size(XY,1) 2 size(XY,2)]);
+end
+
+if nargin < 3, t = 1:size(XY,1); end
+
+validateattributes(XY,{'numeric'},{'real','finite','nonnan','3d'},...
+                   'BRAIDLAB.braid.multiproj','XY',1);
+validateattributes(proj,{'numeric'},...
+                   {'real','finite','vector','nonnan','nonempty'},...
+                   'BRAIDLAB.braid.multiproj','proj',2);
+
+out = cell(1,max(nargout,1));
+[out{:}] = braidlab.braid.colorbraiding(XY,t,proj,true);
+b = out{1};
+if nargout > 1
+  tcr = out{2};
+  if isscalar(proj), tcr = {tcr}; end
+end
+if nargout > 2, prof = out{3}; end
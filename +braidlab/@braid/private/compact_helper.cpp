@@ -33,12 +33,65 @@
 
 // The commute-and-cancel algorithm is from Bangert et al. (2002).
 
+// Handle reduction is from P. Dehornoy, "A fast method for comparing
+// braids," Advances in Math. 125 (1997), 200-235.
+
+// real GCC feature list:
+// https://gcc.gnu.org/projects/cxx0x.html
+#if ( (defined __GNUC__) && (!defined __clang__) )
+
+#define GCCVERSION (__GNUC__ * 10000            \
+                    + __GNUC_MINOR__ * 100      \
+                    + __GNUC_PATCHLEVEL__)
+
+# if ( (!defined BRAIDLAB_NOTHREADING) &&           \
+       ( GCCVERSION < 40600) ) // less than GCC 4.5
+# define BRAIDLAB_NOTHREADING
+# endif
+#endif // gcc
+
+// CLANG: feature list:
+// https://clang.llvm.org/cxx_status.html
+#if (defined __clang__)
+
+#define CLANGVERSION (__clang_major__ * 10000   \
+                      + __clang_minor__ * 100   \
+                      + __clang_patchlevel__)
+
+# if ( (!defined BRAIDLAB_NOTHREADING) &&               \
+       (CLANGVERSION < 30300) ) // less than Clang 3.3
+# define BRAIDLAB_NOTHREADING
+# endif
+
+#endif // clang
+
 #include <iostream>
 #include <vector>
+#include <queue>
 #include <algorithm>
+#include <functional>
+#include <cstdlib>
+
+#ifndef BRAIDLAB_NOTHREADING
+#include <future>
+#include "ThreadPool.h" // (c) Jakob Progsch, Václav Zeman
+                        // https://github.com/progschj/ThreadPool
+#endif
+
 #include "mex.h"
 
-// #undef BRAIDLAB_BANGERT_RESTORE
+// Length of the segments that are compacted independently in
+// multithreaded mode.
+#ifndef BRAIDLAB_COMPACT_SEGMENT
+#define BRAIDLAB_COMPACT_SEGMENT 16384
+#endif
+
+// Number of positions on each side of the seam between two compacted
+// segments that are revisited when they are joined.
+#ifndef BRAIDLAB_COMPACT_SEAM
+#define BRAIDLAB_COMPACT_SEAM 64
+#endif
+
 // #undef BRAIDLAB_COMPACT_DEBUG
 
 extern void _main();
@@ -75,153 +128,672 @@ void printvec(const std::vector<int>& b)
 //
 // I also don't see the point of moving the generator back to where it
 // started.  It works faster (and even better) to just leave it there.
-// This behavior is controlled by BRAIDLAB_BANGERT_RESTORE.
 //
+// The word is stored as a doubly-linked list over the positions of the
+// original word, so that cancelling a pair of generators or moving a
+// generator by one position takes O(1) time.  The positions never
+// change order: a generator is moved by swapping values with its
+// neighbour.
+//
+// Commuting generators alone (without the second relation) is done
+// exactly by reduce(), in a single left-to-right sweep: a generator
+// cancels with the last generator that it does not commute with, if
+// that is its inverse.  The result has no pair of inverse generators
+// separated only by generators that commute with them, which is the
+// fixed point of commute-and-cancel without the second relation.
+//
+// The passes only start moves from "dirty" positions, whose
+// neighbourhood changed since they were last visited in that
+// direction.  A generator whose neighbours (up to two on each side) did
+// not change cannot move, so the other positions are skipped.  The
+// dirty positions are visited in the same order as the original
+// implementation, which starts a move from each index of the word in
+// turn, including the positions that it skips after a cancellation.
+// The passes thus give exactly the same word as the original ones,
+// without erasing the cancelled generators from a vector after each
+// move.  reduce() is only used at the end, and can only shorten the
+// word further.
+//
+class CompactWord
+{
+public:
+  // Word w of length N, for a braid on n strings.  For an annular
+  // braid, generators 1 and n-1 do not commute, and the second
+  // relation is not applied to generator n-1.
+  CompactWord(const int *w, const mwSize N, const int n, const bool annular);
+
+  // Cancel all the pairs of inverse generators separated by commuting
+  // generators.  Returns true if the word got shorter.
+  bool reduce();
+
+  // Move the generators at dirty positions as far as possible to the
+  // right (dir=1) or left (dir=-1), using the second relation if
+  // secndrel is true.  Returns true if the word got shorter.
+  bool pass(const int dir, const bool secndrel);
+
+  // Commute-and-cancel without and then with the second relation until
+  // nothing changes, as in the original implementation.
+  void compact();
+
+  // Commute-and-cancel with both relations until nothing changes,
+  // for a word where only the dirty positions can move (see seam).
+  void recompact();
+
+  // Only revisit the positions within w of the seam before position p
+  // (0-based) in the passes, for a word made of two compacted words.
+  void seam(const mwIndex p, const mwSize w);
+
+  // Number of generators left in the word.
+  mwSize size() const { return len; }
+
+  // Copy the word to b.
+  void word(std::vector<int>& b) const;
+
+private:
+  // Sentinel positions 0 and N+1 hold a zero generator.
+  std::vector<int> gen;
+  std::vector<mwIndex> prv, nxt;
+  mwSize len;
+  const int n;
+  const bool annular;
+
+  // Dirty positions for each direction (0: dir=1, 1: dir=-1).  Those
+  // ahead of the current pass are in queue, the others in pending.
+  std::vector<char> dirty[2];
+  std::vector<mwIndex> pending[2];
+  std::priority_queue<mwIndex, std::vector<mwIndex>,
+                      std::greater<mwIndex> > ahead;  // dir=1
+  std::priority_queue<mwIndex> behind;                // dir=-1
+  int curdir;      // direction of the current pass (0 if none)
+  mwIndex cursor;  // position of the current pass
+
+  mwIndex step(const mwIndex i, const int dir) const
+  { return (dir == 1 ? nxt[i] : prv[i]); }
+
+  bool commute(const int a, const int b) const;
+  bool braidrel(const int a, const int b) const;
 
-template<class T>
-inline
-bool commute_and_cancel(T& b, const int dir, const int n,
-                        const bool secndrel, const bool annular)
+  // Remove the adjacent positions i and nxt[i] from the list.
+  void cancel(const mwIndex i);
+
+  // Mark position i and its neighbours as dirty.
+  void touch(mwIndex i);
+  void mark(const mwIndex i);
+
+  // Move the generator at i in direction dir.  As in the original
+  // implementation, it does not try to cancel once it reaches the end
+  // of the word.  Returns false if it cancelled before moving, in
+  // which case the original pass starts its next move from the same
+  // index.
+  bool move(mwIndex i, const int dir, const bool secndrel);
+};
+
+
+CompactWord::CompactWord(const int *w, const mwSize N, const int nn,
+                         const bool ann)
+  : gen(N+2,0), prv(N+2), nxt(N+2), len(N), n(nn), annular(ann),
+    curdir(0), cursor(0)
+{
+  for (mwIndex i = 0; i < N; ++i) gen[i+1] = w[i];
+  for (mwIndex i = 0; i < N+2; ++i)
+    {
+      prv[i] = (i > 0 ? i-1 : 0);
+      nxt[i] = (i < N+1 ? i+1 : N+1);
+    }
+  for (int d = 0; d < 2; ++d)
+    {
+      dirty[d].assign(N+2,1);
+      dirty[d][0] = dirty[d][N+1] = 0;
+      for (mwIndex i = 1; i <= N; ++i) pending[d].push_back(i);
+    }
+}
+
+
+inline bool CompactWord::commute(const int a, const int b) const
+{
+  const int i = abs(a), j = abs(b);
+  // Omit commutation relation involving strings 1 and n-1 for an
+  // annular braid.
+  if (annular && ((i == 1 && j == n-1) || (i == n-1 && j == 1)))
+    return false;
+  return abs(i - j) > 1;
+}
+
+
+inline bool CompactWord::braidrel(const int a, const int b) const
+{
+  // Omit braid relation involving n-1 for an annular braid.
+  if (annular && (abs(a) == n-1 || abs(b) == n-1)) return false;
+  return true;
+}
+
+
+void CompactWord::cancel(const mwIndex i)
 {
+  const mwIndex j = nxt[i];
 #ifdef BRAIDLAB_COMPACT_DEBUG
-  using std::cerr;
-  using std::endl;
+  std::cerr << "Cancelling adjacent generators at position ";
+  std::cerr << i << " and " << j << std::endl;
 #endif
-  if (b.size() < 2) return false;
+  const mwIndex l = prv[i], r = nxt[j];
+  nxt[l] = r;
+  prv[r] = l;
+  gen[i] = gen[j] = 0;
+  len -= 2;
+  touch(l);
+  touch(r);
+}
+
+
+inline void CompactWord::mark(const mwIndex i)
+{
+  if (gen[i] == 0) return;  // sentinel or removed
+  for (int d = 0; d < 2; ++d)
+    {
+      if (dirty[d][i]) continue;
+      dirty[d][i] = 1;
+      const int dir = (d == 0 ? 1 : -1);
+      if (curdir == dir && (dir == 1 ? i > cursor : i < cursor))
+        {
+          if (dir == 1) ahead.push(i); else behind.push(i);
+        }
+      else
+        {
+          pending[d].push_back(i);
+        }
+    }
+}
 
-  bool shorter = false;
-  bool badrel = false;
-  mwIndex pos0 = 0; // pos0 is the starting point of the "current" generator.
+
+void CompactWord::touch(mwIndex i)
+{
+  // The moves from a position depend on two neighbours on each side.
+  mark(i);
+  mwIndex l = prv[i], r = nxt[i];
+  mark(l); mark(prv[l]);
+  mark(r); mark(nxt[r]);
+}
+
+
+bool CompactWord::move(mwIndex i, const int dir, const bool secndrel)
+{
+  const mwIndex i0 = i;
+  bool moved = false;
   do
     {
-      bool incrpos = false;
-      // dir=1 means start from the beginning, dir=-1 from the end.
-      mwIndex i = (dir == 1 ? pos0 : b.size()-1-pos0);
-#ifdef BRAIDLAB_COMPACT_DEBUG
-      cerr << "Position i = " << i << endl;
-#endif
-#ifdef BRAIDLAB_BANGERT_RESTORE
-      T b0(b);      // Save the braid.
-#endif
-      do
+      if (gen[prv[i]] == -gen[i])
         {
-          if (i > 0)
-            {
-              if (b[i-1] == -b[i] && b[i] != 0)
-                {
-                  // Cancel with the generator on the left.
-#ifdef BRAIDLAB_COMPACT_DEBUG
-                  cerr << "Cancelling adjacent generators at position ";
-                  cerr << i-1 << " and " << i << endl;
-                  cerr << "before: "; printvec(b);
-#endif
-                  b[i-1] = b[i] = 0;
-#ifdef BRAIDLAB_COMPACT_DEBUG
-                  cerr << " after: "; printvec(b);
-#endif
-                  shorter = true;
-                  break;
-                }
-            }
-          if (i < b.size()-1)
-            {
-              if (b[i+1] == -b[i] && b[i] != 0)
-                {
-                  // Cancel with the generator on the right.
-#ifdef BRAIDLAB_COMPACT_DEBUG
-                  cerr << "Cancelling adjacent generators at position ";
-                  cerr << i << " and " << i+1 << endl;
-                  cerr << "before: "; printvec(b);
-#endif
-                  b[i+1] = b[i] = 0;
-#ifdef BRAIDLAB_COMPACT_DEBUG
-                  cerr << " after: "; printvec(b);
-#endif
-                  shorter = true;
-                  break;
-                }
-            }
-          if (annular)
+          // Cancel with the generator on the left.
+          cancel(prv[i]);
+          return moved;
+        }
+      if (gen[nxt[i]] == -gen[i])
+        {
+          // Cancel with the generator on the right.
+          cancel(i);
+          return moved;
+        }
+      const mwIndex j = step(i,dir);
+      if (commute(gen[i],gen[j]))
+        {
+          // Commute with the next generator.
+          std::swap(gen[i],gen[j]);
+          touch(i);
+          touch(j);
+          i = j;
+          moved = true;
+          continue;
+        }
+      const mwIndex k = step(j,dir);
+      if (secndrel && gen[k] != 0 && (gen[i]+1 == gen[j] || gen[i]-1 == gen[j])
+          && gen[i] == gen[k])
+        {
+          // Try the second type of relation.
+          if (braidrel(gen[i],gen[j]))
             {
-              // Omit commutation relation involving strings 1 and n-1
-              // for an annular braid.
-              badrel =
-                (abs(b[i]) == 1 && abs(b[i+dir]) == n-1) ||
-                (abs(b[i]) == n-1 && abs(b[i+dir]) == 1);
 #ifdef BRAIDLAB_COMPACT_DEBUG
-              if (badrel)
-                cerr << "Omitting annular commutation relation.\n";
+              std::cerr << "Using second relation at position ";
+              std::cerr << i << "," << j << "," << k << std::endl;
 #endif
+              std::swap(gen[i],gen[j]);
+              gen[k] = gen[i];
+              touch(i);
+              touch(j);
+              touch(k);
             }
-          if (abs(abs(b[i]) - abs(b[i+dir])) > 1 && !badrel)
+          else
             {
-              // Commute with the next generator.
-#ifdef BRAIDLAB_COMPACT_DEBUG
-              cerr << "Commuting adjacent generators at position ";
-              cerr << i << " and " << i+dir << endl;
-              cerr << "before: "; printvec(b);
-#endif
-              std::swap(b[i],b[i+dir]);
-#ifdef BRAIDLAB_COMPACT_DEBUG
-              cerr << " after: "; printvec(b);
-#endif
-              i += dir;
-              incrpos = true;
-              continue;
+              // The generator skips over the relation without changing
+              // the word, so where it stops depends on more than its
+              // neighbours: keep i0 dirty.
+              mark(i0);
             }
-          if ((int)i+2*dir >= 0 && (int)i+2*dir <= (int)b.size()-1 && secndrel)
+          i = k;
+          moved = true;
+          continue;
+        }
+      // Nothing happened.
+      break;
+    }
+  while (gen[step(i,dir)] != 0);
+  return true;
+}
+
+
+bool CompactWord::pass(const int dir, const bool secndrel)
+{
+  const int d = (dir == 1 ? 0 : 1);
+  const mwSize len0 = len;
+
+  curdir = dir;
+  cursor = (dir == 1 ? 0 : gen.size()-1);
+  for (mwIndex p = 0; p < pending[d].size(); ++p)
+    {
+      if (dir == 1) ahead.push(pending[d][p]); else behind.push(pending[d][p]);
+    }
+  pending[d].clear();
+
+  // The position where the original pass starts its next move.  The
+  // positions before it that were not visited stay dirty.
+  mwIndex next = step(cursor,dir);
+  while (dir == 1 ? !ahead.empty() : !behind.empty())
+    {
+      if (dir == 1) { cursor = ahead.top(); ahead.pop(); }
+      else          { cursor = behind.top(); behind.pop(); }
+      if (gen[cursor] == 0)
+        {
+          // Removed since it was marked.
+          dirty[d][cursor] = 0;
+          continue;
+        }
+      // The original pass stops before the last generator, or when
+      // fewer than two generators are left.
+      if ((dir == 1 ? cursor < next : cursor > next) ||
+          gen[step(cursor,dir)] == 0 || len < 2)
+        {
+          pending[d].push_back(cursor);
+          continue;
+        }
+      dirty[d][cursor] = 0;
+      const mwIndex l = step(cursor,-dir);
+      const mwIndex r = step(step(cursor,dir),dir);
+      if (!move(cursor,dir,secndrel))
+        {
+          // Cancelled with a neighbour without moving: the next index
+          // is now that of r.
+          next = r;
+        }
+      else if (gen[cursor] != 0)
+        {
+          next = step(cursor,dir);
+        }
+      else
+        {
+          // Moved and then cancelled with the generator that took its
+          // place: the next index skips one generator after l.
+          next = step(step(l,dir),dir);
+        }
+    }
+  curdir = 0;
+
+  return (len < len0);
+}
+
+
+bool CompactWord::reduce()
+{
+  const mwSize len0 = len;
+
+  int maxgen = n;
+  for (mwIndex i = nxt[0]; gen[i] != 0; i = nxt[i])
+    maxgen = std::max(maxgen,abs(gen[i]));
+
+  // Positions of the generators kept so far, for each generator index.
+  // Since positions are in list order, the last generator that i does
+  // not commute with is the latest of the tops of the stacks it does
+  // not commute with.
+  std::vector< std::vector<mwIndex> > last(maxgen+2);
+
+  for (mwIndex i = nxt[0]; gen[i] != 0; )
+    {
+      const mwIndex inext = nxt[i];
+      const int g = abs(gen[i]);
+      mwIndex p = 0;
+      for (int h = g-1; h <= g+1; ++h)
+        {
+          if (!last[h].empty()) p = std::max(p,last[h].back());
+        }
+      if (annular)
+        {
+          const int h = (g == 1 ? n-1 : (g == n-1 ? 1 : 0));
+          if (h > 0 && !last[h].empty()) p = std::max(p,last[h].back());
+        }
+      if (p > 0 && gen[p] == -gen[i])
+        {
+          // Cancel with a generator on the left, removing both from the
+          // list.  The generators in between commute with them.
+          last[g].pop_back();
+          const mwIndex pl = prv[p], pr = nxt[p];
+          nxt[pl] = pr; prv[pr] = pl;
+          const mwIndex il = prv[i], ir = nxt[i];
+          nxt[il] = ir; prv[ir] = il;
+          gen[p] = gen[i] = 0;
+          len -= 2;
+          touch(pl);
+          touch(il);
+        }
+      else
+        {
+          last[g].push_back(i);
+        }
+      i = inext;
+    }
+
+  return (len < len0);
+}
+
+
+void CompactWord::compact()
+{
+  // Try to commute_and_cancel from the left/right until nothing changes.
+  // Omit the second type (three-string) of braid relations.
+  while (pass(1,false) || pass(-1,false)) {}
+
+  // Generators that could not move might now move with the second
+  // relation.
+  for (mwIndex i = nxt[0]; gen[i] != 0; i = nxt[i]) mark(i);
+
+  recompact();
+}
+
+
+void CompactWord::recompact()
+{
+  // Try to commute_and_cancel from the left/right until nothing changes.
+  // The second relation can leave pairs that cancel by commuting alone,
+  // so repeat until those are all gone.
+  do
+    {
+      while (pass(1,true) || pass(-1,true)) {}
+    }
+  while (reduce());
+}
+
+
+void CompactWord::seam(const mwIndex p, const mwSize w)
+{
+  const mwSize N = gen.size()-2;
+  for (int d = 0; d < 2; ++d)
+    {
+      std::fill(dirty[d].begin(),dirty[d].end(),0);
+      pending[d].clear();
+    }
+  // Positions are shifted by one for the sentinel.
+  const mwIndex first = (p > w ? p-w : 0) + 1;
+  const mwIndex last = std::min(p+w,N);
+  for (mwIndex i = first; i <= last; ++i) mark(i);
+}
+
+
+void CompactWord::word(std::vector<int>& b) const
+{
+  b.clear();
+  b.reserve(len);
+  for (mwIndex i = nxt[0]; gen[i] != 0; i = nxt[i]) b.push_back(gen[i]);
+}
+
+
+//
+// Cartier-Foata normal form: the word is written as a product of
+// layers of pairwise commuting generators, each generator being in the
+// layer following the last generator before it that it does not
+// commute with.  The generators in each layer are sorted by index.
+//
+// A generator that would land right after its inverse in this order
+// (that is, whose last non-commuting predecessor is its inverse)
+// cancels with it instead.  The positions of the last generator of
+// each index are kept on stacks, so this takes linear time, however far
+// generators commute.  Two words equal up to commutations and free
+// cancellations have the same normal form.
+//
+// On output, b is the normal form and layers holds the length of each
+// layer.
+//
+void foata_form(std::vector<int>& b, std::vector<mwSize>& layers,
+                const int n, const bool annular)
+{
+  const mwSize N = b.size();
+
+  int maxgen = n;
+  for (mwIndex i = 0; i < N; ++i) maxgen = std::max(maxgen,abs(b[i]));
+
+  // Layer (from 1) of each generator, 0 once it has cancelled.
+  std::vector<mwSize> layer(N,0);
+  // Positions of the surviving generators of each index.
+  std::vector< std::vector<mwIndex> > last(maxgen+2);
+
+  for (mwIndex i = 0; i < N; ++i)
+    {
+      const int g = abs(b[i]);
+      // The last generator that i does not commute with is the one in
+      // the highest layer, since those do not commute with each other.
+      mwIndex p = 0;
+      mwSize lp = 0;
+      for (int h = g-1; h <= g+1; ++h)
+        {
+          if (!last[h].empty() && layer[last[h].back()] > lp)
+            { p = last[h].back(); lp = layer[p]; }
+        }
+      if (annular)
+        {
+          // Generators 1 and n-1 do not commute for an annular braid.
+          const int h = (g == 1 ? n-1 : (g == n-1 ? 1 : 0));
+          if (h > 0 && !last[h].empty() && layer[last[h].back()] > lp)
+            { p = last[h].back(); lp = layer[p]; }
+        }
+      if (lp > 0 && b[p] == -b[i])
+        {
+          // Cancel: no surviving generator depends on p, since p is
+          // the last one that does not commute with i.
+          last[g].pop_back();
+          layer[p] = 0;
+        }
+      else
+        {
+          layer[i] = lp+1;
+          last[g].push_back(i);
+        }
+    }
+
+  // A surviving generator's predecessors all survive, so only the top
+  // layers can have emptied through cancellations.
+  mwSize nlayers = 0;
+  for (mwIndex i = 0; i < N; ++i) nlayers = std::max(nlayers,layer[i]);
+
+  // Sort by layer, then by generator index within each layer.
+  std::vector<mwIndex> count(maxgen+2,0), byindex, bylayer;
+  for (mwIndex i = 0; i < N; ++i)
+    if (layer[i]) count[abs(b[i])]++;
+  for (int g = 1; g <= maxgen+1; ++g) count[g] += count[g-1];
+  byindex.resize(count[maxgen+1]);
+  for (mwIndex i = N; i-- > 0; )
+    if (layer[i]) byindex[--count[abs(b[i])]] = i;
+
+  layers.assign(nlayers,0);
+  for (mwIndex k = 0; k < byindex.size(); ++k)
+    layers[layer[byindex[k]]-1]++;
+  std::vector<mwIndex> start(nlayers+1,0);
+  for (mwIndex l = 0; l < nlayers; ++l) start[l+1] = start[l] + layers[l];
+  bylayer.resize(byindex.size());
+  for (mwIndex k = 0; k < byindex.size(); ++k)
+    bylayer[start[layer[byindex[k]]-1]++] = byindex[k];
+
+  std::vector<int> c(bylayer.size());
+  for (mwIndex k = 0; k < bylayer.size(); ++k) c[k] = b[bylayer[k]];
+  b.swap(c);
+}
+
+
+//
+// Dehornoy handle reduction.  A handle is a subword s_i^e u s_i^-e,
+// e=+-1, where u only contains generators s_j with j > i.  It is
+// replaced by u with each s_{i+1}^d changed to s_{i+1}^-e s_i^d
+// s_{i+1}^e, which is the same braid.  Every sequence of such
+// reductions ends, and the final word has no handles: it is then empty
+// if and only if the braid is trivial.
+//
+// The word is read from left to right and the reduced part is kept on
+// a stack, which never contains a handle.  A generator that closes a
+// handle pops it, and the reduced handle is pushed back in front of the
+// letters still to be read.  The last generator of index less than or
+// equal to i is found by following the chain of the positions of the
+// last generator with a smaller index.
+//
+// The reduced word can be longer than the original.
+//
+void handle_reduce(std::vector<int>& b)
+{
+  std::vector<int> out;
+  out.reserve(b.size());
+  // low[k] is the position of the last generator before k in out with
+  // a smaller index than out[k], or -1.
+  std::vector<long> low;
+  low.reserve(b.size());
+  // Letters still to be read, the next one on top.
+  std::vector<int> todo(b.rbegin(),b.rend());
+
+  while (!todo.empty())
+    {
+      const int x = todo.back(); todo.pop_back();
+      const int i = abs(x);
+
+      // Last generator in out with index <= i.  Everything after it
+      // has a larger index.
+      long p = (long)out.size()-1;
+      while (p >= 0 && abs(out[p]) > i) p = low[p];
+
+      if (p >= 0 && out[p] == -x)
+        {
+          // out[p..end] x is a handle.
+          const int e = (out[p] > 0 ? 1 : -1);
+          for (long k = (long)out.size()-1; k > p; --k)
             {
-              // Try the second type of relation.
-              if ((b[i]+1 == b[i+dir] || b[i]-1 == b[i+dir])
-                  && b[i] == b[i+2*dir])
+              if (abs(out[k]) == i+1)
                 {
-#ifdef BRAIDLAB_COMPACT_DEBUG
-                  cerr << "Using second relation at position ";
-                  cerr << i << "," << i+dir << "," << i+2*dir << endl;
-                  cerr << "before: "; printvec(b);
-#endif
-                  if (annular)
-                    {
-                      // Omit braid relation involving n-1 for an
-                      // annular braid.
-                      badrel =
-                        (abs(b[i]) == n-1 ||
-                         abs(b[i+dir]) == n-1 ||
-                         abs(b[i+2*dir]) == n-1);
-#ifdef BRAIDLAB_COMPACT_DEBUG
-                      if (badrel)
-                        cerr << "Omitting annular braid relation.\n";
-#endif
-                    }
-                  if (!badrel)
-                    {
-                      std::swap(b[i],b[i+dir]);
-                      b[i+2*dir] = b[i];
-                    }
-#ifdef BRAIDLAB_COMPACT_DEBUG
-                  cerr << " after: "; printvec(b);
-#endif
-                  i += 2*dir;
-                  incrpos = true;
-                  continue;
+                  const int d = (out[k] > 0 ? 1 : -1);
+                  todo.push_back(e*(i+1));
+                  todo.push_back(d*i);
+                  todo.push_back(-e*(i+1));
+                }
+              else
+                {
+                  todo.push_back(out[k]);
                 }
             }
-          // Nothing happened: break out of the loop to increase pos0
-          // and try again.
-#ifdef BRAIDLAB_BANGERT_RESTORE
-          b = b0;   // Restore braid, so generator moves back to its
-                    // initial position.
+          out.resize(p);
+          low.resize(p);
+        }
+      else
+        {
+          if (p >= 0 && abs(out[p]) == i) p = low[p];
+          out.push_back(x);
+          low.push_back(p);
+        }
+    }
+
+  b.swap(out);
+}
+
+
+// Compact the word b.
+void compact_word(std::vector<int>& b, const int n, const bool annular)
+{
+  CompactWord cw(b.data(),b.size(),n,annular);
+  cw.compact();
+  cw.word(b);
+}
+
+
+// Append the word b to a and compact the result, where a and b are
+// already compacted: only the positions near the seam are revisited.
+void compact_join(std::vector<int>& a, const std::vector<int>& b,
+                  const int n, const bool annular)
+{
+  const mwIndex p = a.size();
+  a.insert(a.end(),b.begin(),b.end());
+  CompactWord cw(a.data(),a.size(),n,annular);
+  cw.seam(p,BRAIDLAB_COMPACT_SEAM);
+  cw.recompact();
+  cw.word(a);
+}
+
+
+#ifndef BRAIDLAB_NOTHREADING
+//
+// Divide-and-conquer compaction: the word is cut into segments of
+// length BRAIDLAB_COMPACT_SEGMENT that are compacted independently,
+// then neighbouring segments are joined pairwise, level by level, each
+// join only revisiting the seam.  All the segments of a level are
+// processed concurrently on the thread pool.  The segments do not
+// depend on the number of threads, so neither does the result, even
+// with a single thread.
+//
+// The result is not the same as compacting the whole word at once
+// (commute-and-cancel is a heuristic, and the order of the moves
+// differs), but it has about the same length: within 1% for random
+// words.  Unlike compact_word, it is not guaranteed to be at most as
+// long as with the original implementation, so it is only used when
+// parallel compaction is requested explicitly.
+//
+void compact_parallel(std::vector<int>& b, const int n, const bool annular,
+                      const size_t Nthreads)
+{
+  const mwSize N = b.size();
+  const mwSize L = BRAIDLAB_COMPACT_SEGMENT;
+
+  std::vector< std::vector<int> > seg((N+L-1)/L);
+  for (mwIndex k = 0; k < seg.size(); ++k)
+    seg[k].assign(b.begin()+k*L, b.begin()+std::min((k+1)*L,N));
+  std::vector<int>().swap(b);  // free the memory
+
+  ThreadPool pool(Nthreads);
+  std::vector< std::future<void> > done;
+
+  for (mwIndex k = 0; k < seg.size(); ++k)
+    done.push_back(pool.enqueue(compact_word,std::ref(seg[k]),n,annular));
+  for (mwIndex k = 0; k < done.size(); ++k) done[k].get();
+
+  while (seg.size() > 1)
+    {
+      done.clear();
+      for (mwIndex k = 0; k+1 < seg.size(); k += 2)
+        done.push_back(pool.enqueue(compact_join,std::ref(seg[k]),
+                                    std::cref(seg[k+1]),n,annular));
+      for (mwIndex k = 0; k < done.size(); ++k) done[k].get();
+
+      // Keep the joined segments, and the odd one out.
+      mwIndex m = 0;
+      for (mwIndex k = 0; k < seg.size(); k += 2) seg[m++].swap(seg[k]);
+      seg.resize(m);
+    }
+
+  b.swap(seg[0]);
+}
 #endif
-          incrpos = true;
-          break;
-        } while ((int)i+dir >= 0 && (int)i+dir <= (int)b.size()-1);
-      // remove 0's from the vector.
-      b.erase(remove(b.begin(),b.end(),0),b.end());
-      if (b.size() < 2) break;
-      if (incrpos) ++pos0;
-    } while (pos0 < b.size()-1);
-
-  return shorter; // true if actually shorter than upon entry.
+
+
+// Compact the word b, in parallel on Nthreads threads if Nthreads > 0
+// and the word is long enough, and serially otherwise.  The serial
+// result does not depend on Nthreads.
+void compact_threaded(std::vector<int>& b, const int n, const bool annular,
+                      const size_t Nthreads)
+{
+#ifndef BRAIDLAB_NOTHREADING
+  if (Nthreads > 0 && b.size() > 2*BRAIDLAB_COMPACT_SEGMENT)
+    compact_parallel(b,n,annular,Nthreads);
+  else
+#endif
+    compact_word(b,n,annular);
 }
 
 
@@ -261,21 +833,49 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
   // Third argument determines whether this is an annular braid.
   const int annular = (int)mxGetScalar(prhs[2]);
 
-  // Convert braid word to vector.
-  std::vector<int> bw;
-  for (mwIndex i = 0; i < N; ++i)
-    {
-      bw.push_back(w[i]);
-    }
+  // Optional fourth argument is the number of threads for parallel
+  // compaction (0 for serial).
+  size_t Nthreads = 0;
+  if (nrhs > 3) Nthreads = (size_t)std::max(mxGetScalar(prhs[3]),0.);
 
-  // Try to commute_and_cancel from the left/right until nothing changes.
-  // Omit the second type (three-string) of braid relations.
-  while (commute_and_cancel(bw,1,n,false,annular) ||
-         commute_and_cancel(bw,-1,n,false,annular)) {}
+  // Optional fifth argument is the mode:
+  //   0: compact (default);
+  //   1: Cartier-Foata normal form, with the lengths of its layers as a
+  //      second output;
+  //   2: handle reduction (not for annular braids);
+  //   3: compact, but keep the shorter of the compacted word and the
+  //      compacted handle reduction (not for annular braids).
+  const int mode = (nrhs > 4 ? (int)mxGetScalar(prhs[4]) : 0);
 
-  // Try to commute_and_cancel from the left/right until nothing changes.
-  while (commute_and_cancel(bw,1,n,true,annular) ||
-         commute_and_cancel(bw,-1,n,true,annular)) {}
+  std::vector<int> bw(w,w+N);
+
+  if (mode == 1)
+    {
+      std::vector<mwSize> layers;
+      foata_form(bw,layers,n,annular);
+      if (nlhs > 1)
+        {
+          plhs[1] = mxCreateDoubleMatrix(1,layers.size(),mxREAL);
+          std::copy(layers.begin(),layers.end(),mxGetPr(plhs[1]));
+        }
+    }
+  else if (mode == 2)
+    {
+      handle_reduce(bw);
+    }
+  else if (mode == 3)
+    {
+      std::vector<int> bh(bw);
+      handle_reduce(bh);
+      if (!bh.empty()) compact_threaded(bh,n,false,Nthreads);
+      // A trivial braid always reduces to the empty word.
+      if (!bh.empty()) compact_threaded(bw,n,false,Nthreads);
+      if (bh.empty() || bh.size() < bw.size()) bw.swap(bh);
+    }
+  else
+    {
+      compact_threaded(bw,n,annular,Nthreads);
+    }
 
   // Now copy vector bw to an mxArray of int32's.
   plhs[0] = mxCreateNumericMatrix(1,bw.size(),mxINT32_CLASS,mxREAL);
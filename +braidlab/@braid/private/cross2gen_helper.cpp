@@ -40,12 +40,36 @@
 /*
 *** Inputs:
 XY       - nT x 2 x nStrings matrix specifying the trajectory
-t        - nT x 1            vector specifying the time vector
+           (double or single)
+t        - nT x 1            vector specifying the time vector (double)
+AbsTol   - absolute tolerance for coincident coordinates
 Nthreads - number of computational threads requested
+proj     - (optional) vector of projection angles, or [] for a single
+           projection onto the X axis; see below
+reduce   - (optional) online reduction of the generators: 0 (none),
+           1 (cancel adjacent inverse generators), 2 (also cancel
+           generators separated by commuting ones); see Reduce.  The
+           surviving generators keep their crossing times.
 
 *** Outputs:
 gen      - nG x 1 vector of generators in the braid
 tgen     - nG x 1 vector of timesteps ast which the generators were detected
+prof     - (optional) profile of the run, a struct with fields
+           wall, cpu   - structs of wall-clock and CPU times (msec) of the
+                         phases: detection, sort, blocks, output
+           threads     - number of threads used for crossing detection
+           crossings   - number of pairwise crossings
+           blocksizes  - blocksizes(k) is the number of blocks of k
+                         concurrent crossings
+           threadtasks - number of detection tasks run by each thread
+           CPU time is summed over all threads.  The profile is only
+           collected if it is requested.
+
+If proj is given, the braid is computed for every projection angle in
+a single pass over the data, and gen and tgen are 1 x numel(proj) cell
+arrays.  In that case XY need not be sorted by initial X coordinate,
+and errors refer to the original string indices.  Sorting is then
+part of the blocks phase of the profile.
 
 */
 
@@ -53,6 +77,88 @@ tgen     - nG x 1 vector of timesteps ast which the generators were detected
 #define p_t (prhs[1])
 #define p_AbsTol (prhs[2])
 #define p_Nthreads (prhs[3])
+#define p_proj (prhs[4])
+#define p_reduce (prhs[5])
+
+// Wrap the input arrays in containers of element type T and run the
+// crossing detection.
+template <typename T>
+std::pair< std::vector<int>, std::vector<double> >
+cross2gen_typed( const mxArray *XY, const mxArray *tv, double AbsTol,
+                 size_t NThreadsRequested, Reduce reduce, Timer& tictoc,
+                 Profile* profile )
+{
+  Real3DMatrix<T> trj = Real3DMatrix<T>( XY );
+  if ( trj.C() != 2 ) {
+    mexErrMsgIdAndTxt("BRAIDLAB:braid:cross2gen_helper:input",
+                      "Trajectory should have 2 columns.");
+  }
+
+  RealVector<double> t = RealVector<double>( tv );
+
+  if ( trj.R() != t.N() ) {
+    mexErrMsgIdAndTxt(
+        "BRAIDLAB:braid:cross2gen_helper:input",
+        "Trajectory matrix and time vector should have same number of rows.");
+  }
+
+  if (2 <= BRAIDLAB_debuglvl)  {
+    printf("Trajectories:\n");
+    trj.print();
+  }
+
+  tictoc.tic();
+  // apply pairwise crossing generator
+  std::pair< std::vector<int>, std::vector<double> >
+    retval = cross2gen( trj, t, AbsTol, NThreadsRequested, reduce,
+                        profile );
+  tictoc.toc("Algorithm");
+
+  return retval;
+}
+
+// As cross2gen_typed, for the projection angles in proj.
+template <typename T>
+std::vector< std::pair< std::vector<int>, std::vector<double> > >
+cross2gen_multiproj_typed( const mxArray *XY, const mxArray *tv,
+                           const std::vector<double>& proj, double AbsTol,
+                           size_t NThreadsRequested, Reduce reduce,
+                           Timer& tictoc, Profile* profile )
+{
+  Real3DMatrix<T> trj = Real3DMatrix<T>( XY );
+  if ( trj.C() != 2 ) {
+    mexErrMsgIdAndTxt("BRAIDLAB:braid:cross2gen_helper:input",
+                      "Trajectory should have 2 columns.");
+  }
+
+  RealVector<double> t = RealVector<double>( tv );
+
+  if ( trj.R() != t.N() ) {
+    mexErrMsgIdAndTxt(
+        "BRAIDLAB:braid:cross2gen_helper:input",
+        "Trajectory matrix and time vector should have same number of rows.");
+  }
+
+  tictoc.tic();
+  std::vector< std::pair< std::vector<int>, std::vector<double> > >
+    retval = cross2gen_multiproj( trj, t, proj, AbsTol, NThreadsRequested,
+                                  reduce, profile );
+  tictoc.toc("Algorithm");
+
+  return retval;
+}
+
+// copy a vector to a newly created nx1 double matrix
+template <typename V>
+mxArray* vectorToColumn( const V& v ) {
+  mxArray* out = mxCreateDoubleMatrix( v.size(), 1, mxREAL );
+  double* pr = mxGetPr(out);
+  for ( typename V::const_iterator it = v.begin(); it != v.end(); it++ ) {
+    *pr = (double) *it;
+    pr++;
+  }
+  return out;
+}
 
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
 
@@ -114,58 +220,93 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
                       "AbsTol must be a positive number.");
 
 
-  Timer tictoc(1);
-
-  Real3DMatrix trj = Real3DMatrix( p_XY );
-  if ( trj.C() != 2 ) {
-    mexErrMsgIdAndTxt("BRAIDLAB:braid:cross2gen_helper:input",
-                      "Trajectory should have 2 columns.");
+  Reduce reduce = REDUCE_NONE;
+  if ( nrhs >= 6 ) {
+    int r = (int) mxGetScalar(p_reduce);
+    if ( r < REDUCE_NONE || r > REDUCE_COMMUTE )
+      mexErrMsgIdAndTxt("BRAIDLAB:braid:cross2gen_helper:input",
+                        "Reduction should be 0, 1 or 2.");
+    reduce = (Reduce) r;
   }
 
-  RealVector t = RealVector( p_t );
+  // the profile is only collected if it is returned
+  Profile prof;
+  Profile* profile = nlhs >= 3 ? &prof : 0;
 
-  if ( trj.R() != t.N() ) {
-    mexErrMsgIdAndTxt(
-        "BRAIDLAB:braid:cross2gen_helper:input",
-        "Trajectory matrix and time vector should have same number of rows.");
-  }
+  Timer tictoc(1, profile);
 
-  if (2 <= BRAIDLAB_debuglvl)  {
-    printf("Trajectories:\n");
-    trj.print();
-  }
+  // errors thrown by the algorithm, reported as MATLAB errors
+  std::string errid, errmsg;
 
+  // several projection angles: return cell arrays of results
+  if ( nrhs >= 5 && !mxIsEmpty(p_proj) ) {
+    if ( !mxIsDouble(p_proj) )
+      mexErrMsgIdAndTxt("BRAIDLAB:braid:cross2gen_helper:input",
+                        "Projection angles should be a double vector.");
+    std::vector<double> proj( mxGetPr(p_proj),
+                              mxGetPr(p_proj) + mxGetNumberOfElements(p_proj) );
 
-  tictoc.tic();
-  std::pair< std::vector<int>, std::vector<double> >
-  // apply pairwise crossing generator
-    retval = cross2gen( trj, t, AbsTol, NThreadsRequested );
-  tictoc.toc("Algorithm");
+    std::vector< std::pair< std::vector<int>, std::vector<double> > > retval;
+    try {
+      if ( mxIsSingle(p_XY) )
+        retval = cross2gen_multiproj_typed<float>( p_XY, p_t, proj, AbsTol,
+                                                   NThreadsRequested, reduce,
+                                                   tictoc, profile );
+      else
+        retval = cross2gen_multiproj_typed<double>( p_XY, p_t, proj, AbsTol,
+                                                    NThreadsRequested, reduce,
+                                                    tictoc, profile );
+    }
+    catch( PWXexception& e ) {
+      // report outside of the handler, once the exception is released
+      errid = e.id();
+      errmsg = e.what();
+    }
+    if ( !errid.empty() )
+      mexErrMsgIdAndTxt(errid.c_str(), "%s", errmsg.c_str());
+
+    tictoc.tic();
+    if (nlhs >= 1) {
+      plhs[0] = mxCreateCellMatrix( 1, proj.size() );
+      for (size_t k = 0; k < proj.size(); k++)
+        mxSetCell( plhs[0], k, vectorToColumn( retval[k].first ) );
+    }
+    if (nlhs >= 2) {
+      plhs[1] = mxCreateCellMatrix( 1, proj.size() );
+      for (size_t k = 0; k < proj.size(); k++)
+        mxSetCell( plhs[1], k, vectorToColumn( retval[k].second ) );
+    }
+    tictoc.toc("Copying the output", false, "output");
+    if (nlhs >= 3) plhs[2] = prof.toStruct();
+    return;
+  }
+
+  // dispatch on the class of the trajectory data; single-precision
+  // data is consumed in place, without a conversion to double
+  std::pair< std::vector<int>, std::vector<double> > retval;
+  try {
+    if ( mxIsSingle(p_XY) )
+      retval = cross2gen_typed<float>( p_XY, p_t, AbsTol, NThreadsRequested,
+                                       reduce, tictoc, profile );
+    else
+      retval = cross2gen_typed<double>( p_XY, p_t, AbsTol, NThreadsRequested,
+                                        reduce, tictoc, profile );
+  }
+  catch( PWXexception& e ) {
+    errid = e.id();
+    errmsg = e.what();
+  }
+  if ( !errid.empty() )
+    mexErrMsgIdAndTxt(errid.c_str(), "%s", errmsg.c_str());
 
   tictoc.tic();
 
   // create the list of generators
-  if (nlhs >= 1) {
-    plhs[0] = mxCreateDoubleMatrix( retval.first.size(), 1, mxREAL );
-    double* out = mxGetPr(plhs[0]);
-
-    for ( std::vector<int>::iterator it = retval.first.begin();
-          it != retval.first.end(); it++ ) {
-      *out = (double) *it;
-      out++;
-    }
-  }
+  if (nlhs >= 1) plhs[0] = vectorToColumn( retval.first );
 
-  if (nlhs >= 2) {
-    plhs[1] = mxCreateDoubleMatrix( retval.second.size(), 1, mxREAL );
-    double* out = mxGetPr(plhs[1]);
+  if (nlhs >= 2) plhs[1] = vectorToColumn( retval.second );
 
-    for ( std::vector<double>::iterator it = retval.second.begin();
-          it != retval.second.end(); it++ ) {
-      *out = (double) *it;
-      out++;
-    }
-  }
+  tictoc.toc("Copying the output", false, "output");
 
-  tictoc.toc("Copying the output");
+  if (nlhs >= 3) plhs[2] = prof.toStruct();
 }
@@ -82,11 +82,17 @@
 #include <algorithm>
 #include <cmath>
 #include <ctime>
+#include <chrono>
+#include <string>
 #include <sstream>
 #include <stdexcept>
+#include <unordered_map>
+#include <queue>
+#include <functional>
 
 #ifndef BRAIDLAB_NOTHREADING
 #include <mutex>
+#include <thread>
 #include "ThreadPool.h" // (c) Jakob Progsch, Václav Zeman
                         // https://github.com/progschj/ThreadPool
 #endif
@@ -112,17 +118,56 @@ int BRAIDLAB_debuglvl = -1;
   XYtraj -- (# timesteps) x 2 x (# trajectories/strings) matrix
          "X" and "Y" coordinates correspond to indexing by the second dimension
   t      -- (# timesteps) vector
+  reduce -- online reduction of the generator sequence, see Reduce
+  profile -- (optional) times and statistics of the phases, see Profile
 
 */
 
-class Real3DMatrix;
-class RealVector;
+template <typename T> class Real3DMatrix;
+template <typename T> class RealVector;
+class Profile;
+
+/*
+  Reduce
+
+  How the generator sequence is reduced while the crossings are
+  applied.  Data braids are often mostly made of back-and-forth
+  crossings of jittering strings, which cancel.
+    REDUCE_NONE    -- keep every generator;
+    REDUCE_CANCEL  -- cancel a generator with the one just before it, if
+                      it is its inverse;
+    REDUCE_COMMUTE -- cancel a generator with the last generator that it
+                      does not commute with, if it is its inverse.
+  The surviving generators keep their crossing times.
+*/
+enum Reduce { REDUCE_NONE = 0, REDUCE_CANCEL = 1, REDUCE_COMMUTE = 2 };
+
+/*
+  MatlabClass
+
+  Maps the C++ element type of a trajectory container to the MATLAB
+  class of the mxArray it wraps.  Only double and single are
+  supported; trajectories stored in single precision are read as they
+  are, without a conversion to double.
+*/
+template <typename T> struct MatlabClass;
+
+template <> struct MatlabClass<double> {
+  static bool is( const mxArray *in ) { return mxIsDouble(in); }
+  static const char* name() { return "double"; }
+};
+
+template <> struct MatlabClass<float> {
+  static bool is( const mxArray *in ) { return mxIsSingle(in); }
+  static const char* name() { return "single"; }
+};
 
 /*
   Real3DMatrix
 
   Class that helps with access of REAL elements in Matlab 3D matrices.
-  Constructed from Matlab matrix mxArray.
+  Constructed from Matlab matrix mxArray.  The element type T is
+  double or float, matching the class of the mxArray.
 
   Implements operator() for easier access to elements in (row, column,
   span) notation (ZERO BASED INDEXING)
@@ -130,9 +175,10 @@ class RealVector;
   Implements functions R(), C(), S() to access individual dimensions.
 
 */
+template <typename T>
 class Real3DMatrix {
 
-  const double *data;         // data matrix
+  const T *data;     // data matrix
   mwSize _R, _C, _S; // dimensions: rows, cols, spans
 
 public:
@@ -142,16 +188,21 @@ public:
   Real3DMatrix( const mxArray *in );
 
   // access matrix elements using matrix( r, c, s) syntax
-  double operator()( const mwIndex row, const mwIndex col, const mwIndex lay )
+  T operator()( const mwIndex row, const mwIndex col, const mwIndex lay )
     const;
 
+  // pointer to the contiguous column (:, col, lay), i.e., one coordinate
+  // of one string over all time steps; for streaming access without the
+  // per-element index checks of operator()
+  const T* column( const mwIndex col, const mwIndex lay ) const;
+
   // print 3D matrix, each 2D slice at a time
   void print() {
     for ( size_t s = 0; s < S(); s++ ) {
       printf("Slice " BRAIDLAB_PRINTF_SIZE_T ": \n",s);
       for ( size_t r = 0; r < R(); r++ ) {
         for ( size_t c = 0; c < C(); c++ )
-          printf("%.3f\t", (*this)(r, c, s) );
+          printf("%.3f\t", (double) (*this)(r, c, s) );
         printf("\n");
       }
     }
@@ -164,9 +215,10 @@ public:
 
 };
 
+template <typename T>
 class RealVector {
 
-  const double *data;
+  const T *data;
   mwSize _N;
 
 public:
@@ -175,7 +227,7 @@ public:
   RealVector( const mxArray *in );
 
   // access elements using vector( n ) syntax
-  double operator()( const mwIndex n ) const;
+  T operator()( const mwIndex n ) const;
 
   // access size
   mwSize N(void) const { return _N; }
@@ -249,6 +301,8 @@ public:
       return "BRAIDLAB:braid:colorbraiding:coincidentprojection";
     case 3:
       return "BRAIDLAB:braid:colorbraiding:coincidentparticles";
+    case 4:
+      return "BRAIDLAB:braid:colorbraiding:badcrossing";
     default:
       return "BRAIDLAB:braid:colorbraiding:UNKNOWN";
     }
@@ -285,15 +339,18 @@ private:
   the trajectory data.
 
   Implemented as an object to facilitate multithreading computation.
+  Templated on the element type T of the trajectory data (double or
+  float); crossing times are always interpolated in double precision.
 */
+template <typename T>
 class PairCrossings {
 
 public:
 
   // inputs: _XYtraj (trajectory) _t (time)
   // output: storage
-  PairCrossings( Real3DMatrix& _XYtraj,
-                 RealVector& _t,
+  PairCrossings( Real3DMatrix<T>& _XYtraj,
+                 RealVector<double>& _t,
                  std::list<PWX>& crossingStorage,
                  std::list<PWXexception>& errorStorage,
                  const double aAbsTol)
@@ -304,8 +361,9 @@ public:
       Nstrings(_XYtraj.S()),
       AbsTol(aAbsTol) {}
 
-  // run the calculation on T threads
-  void run( size_t T = 1 );
+  // run the calculation on NThreadsRequested threads; the tasks run by
+  // each thread are counted in profile, if given
+  void run( size_t NThreadsRequested = 1, Profile* profile = 0 );
 
   // Detects crossings between string with color "anchor" and all
   // subsequent strings
@@ -314,10 +372,60 @@ public:
 private:
   ThreadSafePWXList listOfCrossings;
   ThreadSafeExceptionList listOfErrors;
-  Real3DMatrix& XYtraj;
-  RealVector& t;
+  Real3DMatrix<T>& XYtraj;
+  RealVector<double>& t;
+  mwSize Nstrings;
+  double AbsTol;
+
+};
+
+/*
+  Class that detects pairwise crossings for several projection lines
+  in a single pass over the trajectory data.
+
+  The coordinates of each pair of strings are read once per time step
+  and rotated on the fly for every projection angle, so no rotated copy
+  of the data is made.  Unlike PairCrossings, the strings need not be
+  sorted: crossings and errors refer to the original string indices.
+*/
+template <typename T>
+class ProjPairCrossings {
+
+public:
+
+  // inputs: _XYtraj (trajectory) _t (time) proj (projection angles)
+  // output: storage (one list of crossings per projection angle)
+  //         errors  (errors encountered)
+  ProjPairCrossings( Real3DMatrix<T>& _XYtraj,
+                     RealVector<double>& _t,
+                     const std::vector<double>& proj,
+                     std::vector< std::list<PWX> >& storage,
+                     std::list<PWXexception>& errors,
+                     double aAbsTol );
+
+  // run the calculation on NThreadsRequested threads; the tasks run by
+  // each thread are counted in profile, if given
+  void run( size_t NThreadsRequested = 1, Profile* profile = 0 );
+
+  // Detects crossings between string with color "anchor" and all
+  // strings with higher colors, for all projection angles.
+  void detectCrossings( mwIndex anchor );
+
+  // projected (X) coordinate of string I at time index ti for
+  // projection angle k, rounded to the precision of the data
+  double X( mwIndex ti, mwIndex I, size_t k ) const;
+
+private:
+  std::vector< std::list<PWX> >& crossings;
+  ThreadSafeExceptionList listOfErrors;
+  Real3DMatrix<T>& XYtraj;
+  RealVector<double>& t;
   mwSize Nstrings;
   double AbsTol;
+  std::vector<double> cosp, sinp; // rotation for each projection angle
+#ifndef BRAIDLAB_NOTHREADING
+  std::mutex mtx; // guards crossings
+#endif
 
 };
 
@@ -334,12 +442,13 @@ public:
 
   // constructor -- number of strings
   // colors are assumed to be 1,2,...,N
-  Strings( mwSize N);
+  Strings( mwSize N, Reduce reduce = REDUCE_NONE );
 
   // constructor -- X0 positions of strings at the initial time
-  // colors are determined by location of elements X0
-  // e.g., [-0.3, 7.2, 1] results in colors [1 3 2]
-  Strings( std::vector<double> X0 );
+  // colors are the indices of X0, locations are given by the order of
+  // the elements of X0
+  // e.g., [-0.3, 7.2, 1] results in locationToColor [1 3 2]
+  Strings( const std::vector<double>& X0, Reduce reduce = REDUCE_NONE );
 
   // Apply a block of concurrent crossings to the list.
   // Returns true if the block was applied consistently
@@ -364,9 +473,25 @@ private:
   // its color (element index)
   std::vector<mwIndex> colorToLocation;
 
-  // storage for braid generators
-  std::list<double> t;
-  std::list<int> braid;
+  // storage for braid generators; a cancelled generator is set to 0
+  // until it is purged
+  std::vector<double> t;
+  std::vector<int> braid;
+
+  // reduction of the generators as they are added
+  Reduce reduce;
+
+  // positions in braid of the surviving generators of each index
+  // (REDUCE_COMMUTE only), and the number of cancelled generators in
+  // braid
+  std::vector< std::vector<mwIndex> > lastOfIndex;
+  mwSize cancelled;
+
+  // add generator gen at time tgen, reducing the braid
+  void pushGenerator( int gen, double tgen );
+
+  // remove the cancelled generators from braid
+  void purge();
 
   // return true if colorToLocation and locationToColor vectors are
   // consistent
@@ -379,6 +504,11 @@ private:
   // == Nstrings)
   std::pair<bool, mwIndex> switchByColor( mwIndex L, mwIndex R );
 
+  // Applies a block of two or more concurrent crossings, without
+  // validating the permutation.  Returns true if all were applied.
+  bool resolveBlock( std::list<PWX>::iterator start,
+                     std::list<PWX>::iterator end );
+
   // Applies a single pairwise crossing to the strings.  Crossing can
   // be applied only if the strings (specified by color) were
   // neighbors by location, in which case the braid is updated and
@@ -398,22 +528,105 @@ private:
 
   Throws PWXexception in case input trajectories
   overlap in X or XY coordinates.
+
+  The order of the strings is compared in the precision T of the
+  data, but the crossing time is interpolated in double precision.
 */
+template <typename T>
 std::pair<bool,PWX> isCrossing( mwIndex ti, mwIndex I, mwIndex J,
-                                Real3DMatrix& XYtraj, RealVector& t);
+                                Real3DMatrix<T>& XYtraj,
+                                RealVector<double>& t);
+
+/*
+  Crossing test kernel: flag the time steps ti in [0, nsteps) where the
+  X coordinates xI and xJ of two strings change order between ti and
+  ti+1, or where they come within AbsTol of each other at ti+1.  Only
+  the flagged steps can contain a crossing or a coincidence, so only
+  those need the full (scalar) test.  The loop is branch-free over
+  contiguous memory so that the compiler can vectorize it.
+  Returns the number of flagged steps.
+*/
+template <typename T>
+size_t flagCandidateSteps( const T* xI, const T* xJ, size_t nsteps,
+                           double AbsTol, unsigned char* flag );
+
+// Projected coordinates of a string at the two ends of a time step.
+struct StepCoords {
+  double X0, X1; // X (projection) coordinate at t(ti) and t(ti+1)
+  double Y0, Y1; // Y coordinate at t(ti) and t(ti+1)
+};
+
+/*
+  Check whether strings I and J, with coordinates sI and sJ, change
+  order during the time step [t0, t1] and interpolate the crossing.
+  Outputs as for isCrossing.
+*/
+std::pair<bool,PWX> interpolateCrossing( double t0, double t1,
+                                         mwIndex I, mwIndex J,
+                                         const StepCoords& sI,
+                                         const StepCoords& sJ );
+
+
+/*
+  Profile of a run of the algorithm: wall-clock and CPU times of its
+  phases (in msec), and the statistics needed to tune the number of
+  threads.  CPU time is that of the whole process, summed over all
+  threads, so it exceeds the wall-clock time of a phase that keeps
+  several threads busy.
+*/
+class Profile {
+
+public:
+
+  Profile() : threads(1), crossings(0) {}
+
+  // accumulate the times of phase name
+  void addPhase( const std::string& name, double wallTime, double cpuTime );
+
+  // count a detection task run by the calling thread (thread-safe)
+  void countTask();
+
+  // add a histogram of the sizes of concurrent blocks of crossings
+  void addBlockSizes( const std::vector<size_t>& hist );
+
+  // create a MATLAB struct with the contents of the profile
+  mxArray* toStruct() const;
 
+  std::vector<std::string> phases;
+  std::vector<double> wall, cpu;
+  size_t threads;   // number of threads used for crossing detection
+  size_t crossings; // number of pairwise crossings
+  std::vector<size_t> blockSizes;  // blockSizes[k-1]: # of blocks of size k
+  std::vector<size_t> threadTasks; // # of detection tasks run by each thread
+
+private:
+#ifndef BRAIDLAB_NOTHREADING
+  std::vector<std::thread::id> taskThreads; // thread of each threadTasks entry
+  std::mutex mtx; // guards threadTasks
+#endif
+};
+
+// Add a block of size concurrent crossings to the histogram hist.
+void countBlock( std::vector<size_t>& hist, size_t size );
 
 // a simple tic-toc style timer for internal profiling
 class Timer {
 
 public:
 
-  Timer( int level ) : debuglevel(level) {}
+  // times are recorded in profile, if given
+  Timer( int level, Profile* prof = 0 ) : debuglevel(level), profile(prof) {}
 
   int debuglevel;
+  Profile* profile;
   clock_t tictime;
-  void tic() { tictime = clock(); }
-  double toc( const char* msg = "Process", bool reset=false );
+  std::chrono::steady_clock::time_point tictimeWall;
+  void tic() { tictime = clock(); tictimeWall = std::chrono::steady_clock::now(); }
+
+  // print the elapsed wall-clock and CPU time and record them under
+  // phase, if given; returns the wall-clock time in msec
+  double toc( const char* msg = "Process", bool reset=false,
+              const char* phase = 0 );
 };
 
 
@@ -432,10 +645,52 @@ public:
   both X and Y coordinates coincide, this is a true trajectory
   intersection, which means that the braid is undefined.
 */
-void assertNotCoincident(const Real3DMatrix& XYtraj, const mwIndex ti,
+template <typename T>
+void assertNotCoincident(const Real3DMatrix<T>& XYtraj, const mwIndex ti,
                          const mwIndex I, const mwIndex J,
                          const double AbsTol);
 
+/*
+  Same check as assertNotCoincident, for the coordinate differences
+  dX and dY of strings I and J.  The code is that of PWXexception, or
+  0 if the strings do not coincide.
+*/
+int coincidenceCode( double dX, double dY, double AbsTol );
+
+// Build the exception reported for coincident strings I and J.
+PWXexception coincidenceError( int code, mwIndex ti, mwIndex I, mwIndex J );
+
+// Append the (1-based) projection angle index k+1 to an error message.
+PWXexception projectionError( const PWXexception& e, size_t k );
+
+// Throw the first of the errors from pairwise detection, if any.
+void reportCrossingErrors( std::list<PWXexception>& crossingErrors );
+
+/*
+  Apply time-sorted crossings to stringSet, one block of concurrent
+  crossings at a time.  Throws PWXexception (code 4) if a block cannot
+  be resolved.  The block sizes are counted in blockSizes, if given.
+*/
+void applyCrossingBlocks( std::list<PWX>& crossings, Strings& stringSet,
+                          std::vector<size_t>* blockSizes = 0 );
+
+/*
+  Compute the algebraic braid for each projection angle in proj, in a
+  single pass over the data (see ProjPairCrossings).  Unlike cross2gen,
+  the trajectories need not be sorted by their initial X coordinate.
+  Returns one (generators, crossing times) pair per projection angle.
+  All the errors thrown name the projection angle (see projectionError).
+  The phases are timed in profile, if given; sorting and block
+  resolution are then a single phase, "blocks", as they run
+  concurrently for the different angles.
+*/
+template <typename T>
+std::vector< std::pair< std::vector<int>, std::vector<double> > >
+cross2gen_multiproj( Real3DMatrix<T>& XYtraj, RealVector<double>& t,
+                     const std::vector<double>& proj,
+                     const double AbsTol, size_t Nthreads,
+                     Reduce reduce = REDUCE_NONE, Profile* profile = 0 );
+
 // signum function
 template <typename T> int sgn(T val);
 
@@ -443,11 +698,13 @@ template <typename T> int sgn(T val);
 
 //////////////////////////// DEFINITIONS  ////////////////////////////
 
+template <typename T>
 std::pair< std::vector<int>, std::vector<double> >
-cross2gen( Real3DMatrix& XYtraj, RealVector& t,
-           const double AbsTol, size_t Nthreads )
+cross2gen( Real3DMatrix<T>& XYtraj, RealVector<double>& t,
+           const double AbsTol, size_t Nthreads, Reduce reduce = REDUCE_NONE,
+           Profile* profile = 0 )
 {
-  Timer tictoc( 1 );
+  Timer tictoc( 1, profile );
   tictoc.tic();
 
   mwSize Nstrings = XYtraj.S();
@@ -459,39 +716,18 @@ cross2gen( Real3DMatrix& XYtraj, RealVector& t,
   std::list<PWX> crossings;
   std::list<PWXexception> crossingErrors;
 
-  PairCrossings pairCrosser( XYtraj, t, crossings, crossingErrors, AbsTol );
+  PairCrossings<T> pairCrosser( XYtraj, t, crossings, crossingErrors, AbsTol );
 
-  pairCrosser.run(Nthreads);
-  tictoc.toc("cross2gen_helper: pairwise crossing detection", true);
+  pairCrosser.run(Nthreads, profile);
+  tictoc.toc("cross2gen_helper: pairwise crossing detection", true,
+             "detection");
 
   // there were crossingErrors in pairwise detection
-  if (! crossingErrors.empty() ) {
-    int count  = 1;
-    // output individual errors
-    if (2 <= BRAIDLAB_debuglvl)  {
-      mexPrintf("List of all crossingErrors encountered:\n");
-      for( std::list<PWXexception>::iterator e = crossingErrors.begin();
-           e != crossingErrors.end();
-           e++, count++ ) {
-        mexPrintf("Error %d: ", count);
-        mexPrintf( e->what() );
-        mexPrintf("\n");
-      }
-    }
-
-    // first error is invoked as a MATLAB error
-    std::stringstream report;
-
-    report << "[";
-    report << crossingErrors.begin()->L << " ";
-    report << crossingErrors.begin()->R << "] | ";
-    report << crossingErrors.begin()->what();
-
-    mexErrMsgIdAndTxt(crossingErrors.begin()->id(), report.str().c_str() );
-  }
+  reportCrossingErrors( crossingErrors );
 
   crossings.sort();
-  tictoc.toc("cross2gen_helper: sorting crossdat", true);
+  tictoc.toc("cross2gen_helper: sorting crossdat", true, "sort");
+  if (profile) profile->crossings = crossings.size();
 
   if (2 <= BRAIDLAB_debuglvl)  {
     printf("cross2gen_helper: Number of crossings " BRAIDLAB_PRINTF_SIZE_T "\n", crossings.size() );
@@ -504,14 +740,148 @@ cross2gen( Real3DMatrix& XYtraj, RealVector& t,
     mexEvalString("pause(0.001);");
   }
 
-  Strings stringSet(Nstrings);
+  Strings stringSet(Nstrings, reduce);
 
   // Cycle through all crossings, apply them to the strands
-  bool notcrossed;
+  applyCrossingBlocks( crossings, stringSet,
+                       profile ? &profile->blockSizes : 0 );
+
+  tictoc.toc("cross2gen_helper: generating the braid", true, "blocks");
+
+  stringSet.getBraid( retval.first );
+  stringSet.getTime ( retval.second );
+  tictoc.toc("cross2gen_helper: copying output", false, "output");
+
+  return retval;
+
+}
+
+template <typename T>
+std::vector< std::pair< std::vector<int>, std::vector<double> > >
+cross2gen_multiproj( Real3DMatrix<T>& XYtraj, RealVector<double>& t,
+                     const std::vector<double>& proj,
+                     const double AbsTol, size_t Nthreads,
+                     Reduce reduce, Profile* profile )
+{
+  Timer tictoc( 1, profile );
+  tictoc.tic();
+
+  const size_t Nproj = proj.size();
+  mwSize Nstrings = XYtraj.S();
+
+  std::vector< std::list<PWX> > crossings( Nproj );
+  std::list<PWXexception> crossingErrors;
+
+  ProjPairCrossings<T> pairCrosser( XYtraj, t, proj, crossings,
+                                    crossingErrors, AbsTol );
+
+  pairCrosser.run(Nthreads, profile);
+  tictoc.toc("cross2gen_helper: pairwise crossing detection", true,
+             "detection");
+
+  reportCrossingErrors( crossingErrors );
+
+  if (profile) {
+    for (size_t k = 0; k < Nproj; k++)
+      profile->crossings += crossings[k].size();
+  }
+
+  // return braid information, one entry per projection angle
+  std::vector< std::pair< std::vector<int>, std::vector<double> > >
+    retval( Nproj );
+
+  // block sizes for each projection, merged into the profile at the end
+  std::vector< std::vector<size_t> > blockSizes( profile ? Nproj : 0 );
+
+  // sort the crossings and convert them to generators for projection k
+  auto generate = [&]( size_t k ) {
+    // the initial projected positions determine the order of the strings
+    std::vector<double> X0( Nstrings );
+    for (mwIndex I = 0; I < Nstrings; I++)
+      X0[I] = pairCrosser.X( 0, I, k );
+    Strings stringSet( X0, reduce );
+
+    crossings[k].sort();
+    try {
+      applyCrossingBlocks( crossings[k], stringSet,
+                           profile ? &blockSizes[k] : 0 );
+    }
+    catch( PWXexception& e ) {
+      // report the projection angle, as for the coincidence errors
+      throw projectionError( e, k );
+    }
+
+    stringSet.getBraid( retval[k].first );
+    stringSet.getTime ( retval[k].second );
+  };
+
+#ifndef BRAIDLAB_NOTHREADING
+  // debugging output is only safe from the main thread
+  if ( Nthreads > 1 && Nproj > 1 && BRAIDLAB_debuglvl < 3 ) {
+    std::vector< std::future<void> > done;
+    {
+      ThreadPool pool( Nthreads < Nproj ? Nthreads : Nproj );
+      for (size_t k = 0; k < Nproj; k++)
+        done.push_back( pool.enqueue( generate, k ) );
+    } // pool destructor waits for all tasks
+    // rethrows the first error, in the order of the projection angles
+    for (size_t k = 0; k < Nproj; k++)
+      done[k].get();
+  }
+  else
+#endif
+  {
+    for (size_t k = 0; k < Nproj; k++)
+      generate( k );
+  }
+  tictoc.toc("cross2gen_helper: generating the braids", true, "blocks");
+
+  if (profile) {
+    for (size_t k = 0; k < Nproj; k++)
+      profile->addBlockSizes( blockSizes[k] );
+  }
+
+  return retval;
+
+}
+
+void reportCrossingErrors( std::list<PWXexception>& crossingErrors ) {
+
+  if ( crossingErrors.empty() ) return;
+
+  int count  = 1;
+  // output individual errors
+  if (2 <= BRAIDLAB_debuglvl)  {
+    mexPrintf("List of all crossingErrors encountered:\n");
+    for( std::list<PWXexception>::iterator e = crossingErrors.begin();
+         e != crossingErrors.end();
+         e++, count++ ) {
+      mexPrintf("Error %d: ", count);
+      mexPrintf( e->what() );
+      mexPrintf("\n");
+    }
+  }
+
+  // first error is invoked as a MATLAB error
+  std::stringstream report;
+
+  report << "[";
+  report << crossingErrors.begin()->L << " ";
+  report << crossingErrors.begin()->R << "] | ";
+  report << crossingErrors.begin()->what();
+
+  PWXexception e(report.str(), crossingErrors.begin()->L,
+                 crossingErrors.begin()->R);
+  e.code = crossingErrors.begin()->code;
+  throw e;
+}
+
+void applyCrossingBlocks( std::list<PWX>& crossings, Strings& stringSet,
+                          std::vector<size_t>* blockSizes ) {
+
   std::list<PWX>::iterator blockStart = crossings.begin();
   std::list<PWX>::iterator blockEnd;
 
-  size_t cnt = 0;
   while (blockStart != crossings.end() ) {
 
     // determine the block of crossings that happen
@@ -520,10 +890,13 @@ cross2gen( Real3DMatrix& XYtraj, RealVector& t,
     blockEnd++;
     // all times within ABSTOL_TIME are considered to being concurrent
     // blockEnd is the first non-concurrent crossing
-    while ( std::abs(blockStart->t - blockEnd->t) < ABSTOL_TIME ) {
+    while ( blockEnd != crossings.end() &&
+            std::abs(blockStart->t - blockEnd->t) < ABSTOL_TIME ) {
       blockEnd++;
     }
 
+    if (blockSizes)
+      countBlock( *blockSizes, distance( blockStart, blockEnd ) );
 
     // apply the crossings to the permutation vector and update the braid
     bool success = stringSet.applyCrossings(blockStart, blockEnd);
@@ -543,23 +916,22 @@ cross2gen( Real3DMatrix& XYtraj, RealVector& t,
       msg << distance( blockStart, blockEnd );
       msg << " crossings between " << startN << " and "
           << endN << " cannot be resolved.";
-      mexErrMsgIdAndTxt(
-            "BRAIDLAB:braid:colorbraiding:badcrossing", msg.str().c_str());
+      PWXexception e(msg.str(), blockStart->L+1, blockStart->R+1);
+      e.code = 4;
+      throw e;
     }
   }
 
-  tictoc.toc("cross2gen_helper: generating the braid", true);
-
-  stringSet.getBraid( retval.first );
-  stringSet.getTime ( retval.second );
-  tictoc.toc("cross2gen_helper: copying output");
-
-  return retval;
-
 }
 
 // constructor from MATLAB
-Real3DMatrix::Real3DMatrix( const mxArray *in ) : data( mxGetPr(in) ) {
+template <typename T>
+Real3DMatrix<T>::Real3DMatrix( const mxArray *in )
+  : data( (const T*) mxGetData(in) ) {
+  if ( !MatlabClass<T>::is(in) )
+    mexErrMsgIdAndTxt("BRAIDLAB:braid:colorbraiding:badclass",
+                      "Requires 3d matrix of class %s.",
+                      MatlabClass<T>::name());
   if ( mxGetNumberOfDimensions(in) != 3 )
     mexErrMsgIdAndTxt("BRAIDLAB:braid:colorbraiding:not3d",
                       "Requires 3d matrix.");
@@ -570,7 +942,8 @@ Real3DMatrix::Real3DMatrix( const mxArray *in ) : data( mxGetPr(in) ) {
 }
 
 // access elements
-double Real3DMatrix::operator()
+template <typename T>
+T Real3DMatrix<T>::operator()
   (const mwIndex row, const mwIndex col, const mwIndex lay ) const
 {
   if ( !( row < _R) )
@@ -589,19 +962,36 @@ double Real3DMatrix::operator()
   return data[(lay*_C + col)*_R + row];
 }
 
+template <typename T>
+const T* Real3DMatrix<T>::column( const mwIndex col, const mwIndex lay ) const
+{
+  if ( !( col < _C) || !( lay < _S) )
+    mexErrMsgIdAndTxt("BRAIDLAB:braid:colorbraiding:out_of_bounds",
+                      "Column or span index out of bounds "
+                      "(Remember: zero indexing used)");
+
+  return data + (lay*_C + col)*_R;
+}
+
 // constructor from MATLAB
-RealVector::RealVector( const mxArray *in )
+template <typename T>
+RealVector<T>::RealVector( const mxArray *in )
 {
+  if ( !MatlabClass<T>::is(in) )
+    mexErrMsgIdAndTxt("BRAIDLAB:braid:colorbraiding:badclass",
+                      "Requires 1d matrix (array) of class %s.",
+                      MatlabClass<T>::name());
   if ( mxGetNumberOfDimensions(in) != 2 )
     mexErrMsgIdAndTxt("BRAIDLAB:braid:colorbraiding:not1d",
                       "Requires 1d matrix (array).");
   _N = mxGetDimensions(in)[0] > 1 ?
     mxGetDimensions(in)[0] : mxGetDimensions(in)[1];
-  data = mxGetPr(in);
+  data = (const T*) mxGetData(in);
 }
 
 // access elements using vector( n ) syntax
-double RealVector::operator()( const mwIndex n ) const {
+template <typename T>
+T RealVector<T>::operator()( const mwIndex n ) const {
   if ( !( n < _N) )
     mexErrMsgIdAndTxt("BRAIDLAB:braid:colorbraiding:out_of_bounds",
                       "Index out of bounds");
@@ -610,17 +1000,97 @@ double RealVector::operator()( const mwIndex n ) const {
 
 
 // retrieve and print elapsed time
-double Timer::toc( const char* msg, bool reset ) {
+double Timer::toc( const char* msg, bool reset, const char* phase ) {
 
-  clock_t t = clock() - tictime;
+  double cpu = (1000.*(clock() - tictime))/CLOCKS_PER_SEC;
+  double wall = std::chrono::duration<double, std::milli>
+    ( std::chrono::steady_clock::now() - tictimeWall ).count();
 
   if (debuglevel <= BRAIDLAB_debuglvl) {
-    printf("%s took %f msec.\n", msg, (1000.*t)/CLOCKS_PER_SEC );
+    printf("%s took %f msec (%f msec CPU).\n", msg, wall, cpu );
     mexEvalString("pause(0.001);");//flush
   }
+  if (profile && phase)
+    profile->addPhase( phase, wall, cpu );
   if (reset)
     tic();
-  return t;
+  return wall;
+}
+
+void Profile::addPhase( const std::string& name, double wallTime,
+                        double cpuTime ) {
+  size_t k = std::find( phases.begin(), phases.end(), name ) - phases.begin();
+  if ( k == phases.size() ) {
+    phases.push_back( name );
+    wall.push_back( 0 );
+    cpu.push_back( 0 );
+  }
+  wall[k] += wallTime;
+  cpu[k] += cpuTime;
+}
+
+void Profile::countTask() {
+#ifndef BRAIDLAB_NOTHREADING
+  std::lock_guard<std::mutex> lock(mtx);
+  std::thread::id id = std::this_thread::get_id();
+  size_t k = std::find( taskThreads.begin(), taskThreads.end(), id )
+    - taskThreads.begin();
+  if ( k == taskThreads.size() ) {
+    taskThreads.push_back( id );
+    threadTasks.push_back( 0 );
+  }
+  threadTasks[k]++;
+#else
+  if ( threadTasks.empty() ) threadTasks.push_back( 0 );
+  threadTasks[0]++;
+#endif
+}
+
+void Profile::addBlockSizes( const std::vector<size_t>& hist ) {
+  if ( blockSizes.size() < hist.size() )
+    blockSizes.resize( hist.size(), 0 );
+  for (size_t k = 0; k < hist.size(); k++)
+    blockSizes[k] += hist[k];
+}
+
+void countBlock( std::vector<size_t>& hist, size_t size ) {
+  if ( hist.size() < size )
+    hist.resize( size, 0 );
+  hist[size-1]++;
+}
+
+mxArray* Profile::toStruct() const {
+
+  // wall-clock and CPU times, one field per phase
+  std::vector<const char*> names;
+  for (size_t k = 0; k < phases.size(); k++)
+    names.push_back( phases[k].c_str() );
+  mxArray* wallTimes = mxCreateStructMatrix( 1, 1, names.size(),
+                                             names.empty() ? 0 : &names[0] );
+  mxArray* cpuTimes = mxCreateStructMatrix( 1, 1, names.size(),
+                                            names.empty() ? 0 : &names[0] );
+  for (size_t k = 0; k < phases.size(); k++) {
+    mxSetFieldByNumber( wallTimes, 0, k, mxCreateDoubleScalar( wall[k] ) );
+    mxSetFieldByNumber( cpuTimes, 0, k, mxCreateDoubleScalar( cpu[k] ) );
+  }
+
+  // copy a vector of counts to a newly created nx1 double matrix
+  auto counts = []( const std::vector<size_t>& v ) {
+    mxArray* out = mxCreateDoubleMatrix( v.size(), 1, mxREAL );
+    std::copy( v.begin(), v.end(), mxGetPr(out) );
+    return out;
+  };
+
+  const char* fields[] = { "wall", "cpu", "threads", "crossings",
+                           "blocksizes", "threadtasks" };
+  mxArray* out = mxCreateStructMatrix( 1, 1, 6, fields );
+  mxSetField( out, 0, "wall", wallTimes );
+  mxSetField( out, 0, "cpu", cpuTimes );
+  mxSetField( out, 0, "threads", mxCreateDoubleScalar( threads ) );
+  mxSetField( out, 0, "crossings", mxCreateDoubleScalar( crossings ) );
+  mxSetField( out, 0, "blocksizes", counts( blockSizes ) );
+  mxSetField( out, 0, "threadtasks", counts( threadTasks ) );
+  return out;
 }
 
 // print basic information about PWX
@@ -631,7 +1101,16 @@ void PWX::print(int debuglevel = 0) {
   }
 }
 
-void PairCrossings::detectCrossings( mwIndex I ) {
+template <typename T>
+void PairCrossings<T>::detectCrossings( mwIndex I ) {
+
+  // time steps are tested in blocks of this size by the vector kernel
+  const size_t BLOCK = 1024;
+  unsigned char flag[BLOCK];
+
+  const mwSize Nsteps = XYtraj.R() - 1;
+  const T* xI = XYtraj.column( 0, I );
+
   for (mwIndex J = I+1; J < Nstrings; J++) {
     /*
       Determine times at which coordinates change order.
@@ -646,35 +1125,66 @@ void PairCrossings::detectCrossings( mwIndex I ) {
     catch( PWXexception& e ) {
       listOfErrors.push_back( e );
     }
-    // loop over rows
-    for (mwIndex ti = 0; ti < XYtraj.R()-1; ti++) {
-
-      // does a crossing occur at time-index ti between trajectories I and J?
-      try {
 
-        // Check that end-points do not coincide
-        // (beginning was checked in previous iteration)
-        assertNotCoincident( XYtraj, ti+1, I, J, AbsTol );
+    const T* xJ = XYtraj.column( 0, J );
 
-        // first element is true if crossing occurs
-        // second element stores data about crossing
-        std::pair<bool, PWX> interpCross = isCrossing( ti, I, J, XYtraj, t );
+    // loop over rows, a block at a time
+    for (mwIndex t0 = 0; t0 < Nsteps; t0 += BLOCK) {
 
-        // interpolated crossing stored in PWX structure interpCross
-        if (interpCross.first)
-          listOfCrossings.push_back(interpCross.second);
+      const size_t nb = std::min<size_t>( BLOCK, Nsteps - t0 );
 
-      }
-      catch( PWXexception& e ) {
-        listOfErrors.push_back( e );
+      // most blocks have no candidate steps at all
+      if ( flagCandidateSteps( xI + t0, xJ + t0, nb, AbsTol, flag ) == 0 )
         continue;
+
+      for (size_t b = 0; b < nb; b++) {
+        if ( !flag[b] ) continue;
+        mwIndex ti = t0 + b;
+
+        // does a crossing occur at time-index ti between trajectories I
+        // and J?
+        try {
+
+          // Check that end-points do not coincide
+          // (beginning was checked in previous iteration)
+          assertNotCoincident( XYtraj, ti+1, I, J, AbsTol );
+
+          // first element is true if crossing occurs
+          // second element stores data about crossing
+          std::pair<bool, PWX> interpCross =
+            isCrossing( ti, I, J, XYtraj, t );
+
+          // interpolated crossing stored in PWX structure interpCross
+          if (interpCross.first)
+            listOfCrossings.push_back(interpCross.second);
+
+        }
+        catch( PWXexception& e ) {
+          listOfErrors.push_back( e );
+          continue;
+        }
       }
 
     }
   }
 }
 
-void PairCrossings::run( size_t NThreadsRequested ) {
+template <typename T>
+size_t flagCandidateSteps( const T* xI, const T* xJ, size_t nsteps,
+                           double AbsTol, unsigned char* flag ) {
+  size_t count = 0;
+  for (size_t ti = 0; ti < nsteps; ti++) {
+    const bool flip = ( xI[ti] < xJ[ti] ) != ( xI[ti+1] < xJ[ti+1] );
+    const bool near =
+      std::abs( double(xI[ti+1]) - double(xJ[ti+1]) ) < AbsTol;
+    flag[ti] = flip | near;
+    count += flag[ti];
+  }
+  return count;
+}
+
+template <typename T>
+void PairCrossings<T>::run( size_t NThreadsRequested, Profile* profile ) {
 
 #ifndef BRAIDLAB_NOTHREADING
   // each tasks is one "row" of the (I,J) pairing matrix
@@ -689,6 +1199,8 @@ void PairCrossings::run( size_t NThreadsRequested ) {
                       "Number of threads requested must be positive");
   }
 
+  if (profile) profile->threads = NThreadsRequested;
+
   // unthreaded version
   if ( NThreadsRequested == 1 ) {
     if (2 <= BRAIDLAB_debuglvl)  {
@@ -696,18 +1208,19 @@ void PairCrossings::run( size_t NThreadsRequested ) {
       mexEvalString("pause(0.001);"); //flush
     }
     for (mwIndex I = 0; I < Nstrings; I++) {
+      if (profile) profile->countTask();
       detectCrossings(I);
     }
   }
 #ifndef BRAIDLAB_NOTHREADING
   // threaded version
   else {
-    // std::bind creates a function reference to a member function
-    // needed here b/c passing references to member functions
-    // requires explicit object to be referred
-    //
-    auto ptrDetectCrossings = std::bind(&PairCrossings::detectCrossings,
-                                        this, std::placeholders::_1);
+    // each task detects the crossings of one string, counted in the
+    // profile by the thread that runs it
+    auto ptrDetectCrossings = [this, profile]( mwIndex I ) {
+      if (profile) profile->countTask();
+      this->detectCrossings(I);
+    };
     ThreadPool pool(NThreadsRequested); // (c) Jakob Progsch, Václav Zeman
 
     if (2 <= BRAIDLAB_debuglvl)  {
@@ -725,10 +1238,154 @@ void PairCrossings::run( size_t NThreadsRequested ) {
 
 }
 
+template <typename T>
+ProjPairCrossings<T>::ProjPairCrossings( Real3DMatrix<T>& _XYtraj,
+                                         RealVector<double>& _t,
+                                         const std::vector<double>& proj,
+                                         std::vector< std::list<PWX> >& storage,
+                                         std::list<PWXexception>& errors,
+                                         double aAbsTol ) :
+  crossings(storage), listOfErrors(errors),
+  XYtraj(_XYtraj), t(_t), Nstrings(_XYtraj.S()), AbsTol(aAbsTol)
+{
+  // the projection line is rotated counterclockwise by proj, so the
+  // data is rotated clockwise
+  for (size_t k = 0; k < proj.size(); k++) {
+    cosp.push_back( std::cos(proj[k]) );
+    sinp.push_back( std::sin(proj[k]) );
+  }
+}
+
+template <typename T>
+double ProjPairCrossings<T>::X( mwIndex ti, mwIndex I, size_t k ) const {
+  return (T) ( cosp[k]*XYtraj(ti, 0, I) + sinp[k]*XYtraj(ti, 1, I) );
+}
+
+template <typename T>
+void ProjPairCrossings<T>::detectCrossings( mwIndex I ) {
+
+  const size_t Nproj = cosp.size();
+
+  // crossings found by this task, merged into the output at the end
+  std::vector< std::list<PWX> > found( Nproj );
+
+  for (mwIndex J = I+1; J < Nstrings; J++) {
+
+    // raw coordinates of both strings at the beginning of the step
+    double xI = XYtraj(0, 0, I), yI = XYtraj(0, 1, I);
+    double xJ = XYtraj(0, 0, J), yJ = XYtraj(0, 1, J);
+
+    for (size_t k = 0; k < Nproj; k++) {
+      const double c = cosp[k], s = sinp[k];
+      int code = coincidenceCode( (T) (c*xI + s*yI) - (T) (c*xJ + s*yJ),
+                                  (T) (-s*xI + c*yI) - (T) (-s*xJ + c*yJ),
+                                  AbsTol );
+      if ( code )
+        listOfErrors.push_back(
+          projectionError( coincidenceError( code, 0, I, J ), k ) );
+    }
+
+    // loop over rows
+    for (mwIndex ti = 0; ti < XYtraj.R()-1; ti++) {
+
+      // raw coordinates at the end of the step, read once for all angles
+      const double xI1 = XYtraj(ti+1, 0, I), yI1 = XYtraj(ti+1, 1, I);
+      const double xJ1 = XYtraj(ti+1, 0, J), yJ1 = XYtraj(ti+1, 1, J);
+
+      for (size_t k = 0; k < Nproj; k++) {
+        const double c = cosp[k], s = sinp[k];
+
+        // rotate clockwise, rounding to the precision of the data
+        StepCoords sI, sJ;
+        sI.X0 = (T) ( c*xI  + s*yI );   sI.Y0 = (T) ( -s*xI  + c*yI );
+        sI.X1 = (T) ( c*xI1 + s*yI1 );  sI.Y1 = (T) ( -s*xI1 + c*yI1 );
+        sJ.X0 = (T) ( c*xJ  + s*yJ );   sJ.Y0 = (T) ( -s*xJ  + c*yJ );
+        sJ.X1 = (T) ( c*xJ1 + s*yJ1 );  sJ.Y1 = (T) ( -s*xJ1 + c*yJ1 );
+
+        try {
+          // Check that end-points do not coincide
+          // (beginning was checked in previous iteration)
+          int code = coincidenceCode( sI.X1 - sJ.X1, sI.Y1 - sJ.Y1, AbsTol );
+          if ( code )
+            throw coincidenceError( code, ti+1, I, J );
+
+          std::pair<bool, PWX> interpCross =
+            interpolateCrossing( t(ti), t(ti+1), I, J, sI, sJ );
+
+          if (interpCross.first)
+            found[k].push_back(interpCross.second);
+        }
+        catch( PWXexception& e ) {
+          listOfErrors.push_back( projectionError( e, k ) );
+        }
+      }
+
+      xI = xI1; yI = yI1; xJ = xJ1; yJ = yJ1;
+    }
+  }
+
+#ifndef BRAIDLAB_NOTHREADING
+  std::lock_guard<std::mutex> lock(mtx);
+#endif
+  for (size_t k = 0; k < Nproj; k++)
+    crossings[k].splice( crossings[k].end(), found[k] );
+}
+
+template <typename T>
+void ProjPairCrossings<T>::run( size_t NThreadsRequested, Profile* profile ) {
+
+#ifndef BRAIDLAB_NOTHREADING
+  // each tasks is one "row" of the (I,J) pairing matrix
+  // ensure that we do not call more workers than we have tasks
+  NThreadsRequested = NThreadsRequested < Nstrings ? NThreadsRequested : Nstrings;
+#else
+  NThreadsRequested = 1;
+#endif
+
+  if ( NThreadsRequested == 0 ) {
+    mexErrMsgIdAndTxt("BRAIDLAB:braid:colorbraiding:numthreadsnotpositive",
+                      "Number of threads requested must be positive");
+  }
+
+  if (profile) profile->threads = NThreadsRequested;
+
+  if (2 <= BRAIDLAB_debuglvl)  {
+    printf("cross2gen_helper: pairwise crossings for " BRAIDLAB_PRINTF_SIZE_T
+           " projections on " BRAIDLAB_PRINTF_SIZE_T " threads.\n",
+           cosp.size(), NThreadsRequested );
+    mexEvalString("pause(0.001);"); //flush
+  }
+
+  // unthreaded version
+  if ( NThreadsRequested == 1 ) {
+    for (mwIndex I = 0; I < Nstrings; I++) {
+      if (profile) profile->countTask();
+      detectCrossings(I);
+    }
+  }
+#ifndef BRAIDLAB_NOTHREADING
+  // threaded version
+  else {
+    auto ptrDetectCrossings = [this, profile]( mwIndex I ) {
+      if (profile) profile->countTask();
+      this->detectCrossings(I);
+    };
+    ThreadPool pool(NThreadsRequested); // (c) Jakob Progsch, Václav Zeman
+
+    for (mwIndex I = 0; I < Nstrings; I++) {
+      pool.enqueue( ptrDetectCrossings, I);
+    }
+  }
+#endif
+
+}
+
 // initial locations are equal to colors of strings
-Strings::Strings( mwIndex _N ) {
+Strings::Strings( mwIndex _N, Reduce _reduce ) :
+  reduce(_reduce), cancelled(0) {
 
   Nstrings = _N;
+  if ( reduce == REDUCE_COMMUTE ) lastOfIndex.resize( Nstrings+1 );
   // reserve() only sets capacity; resize() is required before indexed writes.
   locationToColor.resize(_N);
   colorToLocation.resize(_N);
@@ -741,9 +1398,23 @@ Strings::Strings( mwIndex _N ) {
 }
 
 // location given by X0
-Strings::Strings( std::vector<double> X0 ) {
-  mexErrMsgIdAndTxt("BRAIDLAB:braid:colorbraiding:notimplemented",
-                    "Strings custom color constructor not implemented");
+Strings::Strings( const std::vector<double>& X0, Reduce _reduce ) :
+  reduce(_reduce), cancelled(0) {
+
+  Nstrings = X0.size();
+  if ( reduce == REDUCE_COMMUTE ) lastOfIndex.resize( Nstrings+1 );
+  locationToColor.resize(Nstrings);
+  colorToLocation.resize(Nstrings);
+
+  for (mwIndex i = 0; i < Nstrings; i++ ) {
+    locationToColor[i] = i;
+  }
+  std::stable_sort( locationToColor.begin(), locationToColor.end(),
+                    [&X0]( mwIndex a, mwIndex b ) { return X0[a] < X0[b]; } );
+  for (mwIndex i = 0; i < Nstrings; i++ ) {
+    colorToLocation[ locationToColor[i] ] = i;
+  }
+
 }
 
 // ensures that the locationToColor and colorToLocation are inverse
@@ -778,38 +1449,93 @@ bool Strings::applyCrossings
   // single crossing was sent -- if it cannot be applied successfuly,
   // there is no way to figure out what went wrong
   if ( distance(start, end) == 1) {
-    return applyCrossing(*start);
+    bool success = applyCrossing(*start);
+    assertLocationColorSanity();
+    return success;
   }
   else {
+    bool success = resolveBlock( start, end );
+    // the swaps of the whole block are validated at once
+    assertLocationColorSanity();
+    return success;
+  }
 
-    double blockStartTime = start->t;
-
-    // Multiple crossings were sent -- cycle through all of them and try
-    // to apply them sequentially and whittle the block to size zero.
-    // Every time we successfully apply a crossing, remove it from the list
-    // and re-start the application from the beginning.
-    // Reaching the end of the list means that in that pass, no applications
-    // were successful, so the list is inconsistent.
-    std::list<PWX> concurrentBlock( start, end );
-    std::list<PWX>::iterator it = concurrentBlock.begin();
-    while ( it != concurrentBlock.end() ) {
-
-      mxAssert(std::abs(blockStartTime - it->t) < ABSTOL_TIME,
-               "Entire block should be roughly concurrent.");
+}
 
-      if ( applyCrossing( *it ) ) { // success -- remove crossing and restart
-        concurrentBlock.erase(it);
-        it = concurrentBlock.begin();
-      }
-      else { // not successful -- try the next
-        it++;
-      }
+// Multiple crossings were sent -- apply them in the order in which the
+// strings become neighbors.  A worklist holds the crossings that may be
+// applicable; applying one only changes the neighbors of the two swapped
+// strings, so only the (at most three) adjacent pairs around the swap
+// need to be looked up again.  The worklist is a min-heap on the position
+// in the block, so the crossings are applied in the same order as by
+// repeatedly applying the first applicable crossing of the block.
+// The block is consistent if all of its crossings could be applied.
+bool Strings::resolveBlock
+  ( std::list<PWX>::iterator start, std::list<PWX>::iterator end )
+{
+  std::vector<PWX> block( start, end );
+  const size_t Nblock = block.size();
+
+  mxAssert( std::abs(block.front().t - block.back().t) < ABSTOL_TIME,
+            "Entire block should be roughly concurrent.");
+
+  // pending crossings of each pair of colors (L,R), in block order:
+  // first[key] is the first one, next[c] the one following c
+  const size_t NONE = Nblock;
+  auto key = [this]( mwIndex L, mwIndex R ) { return L*Nstrings + R; };
+  std::unordered_map<mwIndex, size_t> first( 2*Nblock );
+  std::vector<size_t> next( Nblock, NONE );
+  for (size_t c = Nblock; c-- > 0; ) {
+    std::pair< std::unordered_map<mwIndex, size_t>::iterator, bool > ins =
+      first.insert( std::make_pair( key(block[c].L, block[c].R), c ) );
+    if ( !ins.second ) {
+      next[c] = ins.first->second;
+      ins.first->second = c;
     }
+  }
 
-    // only empty list is a success
-    return concurrentBlock.empty();
+  std::priority_queue< size_t, std::vector<size_t>,
+                       std::greater<size_t> > worklist;
+
+  // queue the first pending crossing of the strings at locations
+  // (loc, loc+1), if any
+  auto enqueueAt = [&]( mwIndex loc ) {
+    if ( loc + 1 >= Nstrings ) return;
+    std::unordered_map<mwIndex, size_t>::iterator it =
+      first.find( key(locationToColor[loc], locationToColor[loc+1]) );
+    if ( it != first.end() && it->second != NONE )
+      worklist.push( it->second );
+  };
+
+  for (mwIndex loc = 0; loc+1 < Nstrings; loc++)
+    enqueueAt( loc );
+
+  size_t applied = 0;
+  while ( !worklist.empty() ) {
+    size_t c = worklist.top();
+    worklist.pop();
+
+    size_t& pending = first[ key(block[c].L, block[c].R) ];
+    // stale entry: already applied, or no longer neighbors
+    if ( pending != c ) continue;
+
+    std::pair<bool, mwIndex> success = switchByColor( block[c].L, block[c].R );
+    if ( !success.first ) continue;
+
+    pending = next[c];
+    applied++;
+    pushGenerator( block[c].L_On_Top ?
+                   (success.second+1) : (-(success.second+1)),
+                   block[c].t );
+
+    // the neighbors around the swapped pair have changed
+    mwIndex loc = success.second;
+    if ( loc > 0 ) enqueueAt( loc-1 );
+    enqueueAt( loc );
+    enqueueAt( loc+1 );
   }
 
+  return applied == Nblock;
 }
 
 // copy braid and time to PREALLOCATED double arrays
@@ -818,19 +1544,23 @@ mwSize Strings::braidSize() {
 
   mxAssert(braid.size() == t.size(),
            "Braid and time vector have inconsistent sizes" );
-  return braid.size();
+  return braid.size() - cancelled;
 
 }
 void Strings::getBraid( std::vector<int>& data ) {
 
   data.clear();
-  std::copy(braid.begin(), braid.end(), std::back_inserter(data));
+  data.reserve( braidSize() );
+  for (mwIndex i = 0; i < braid.size(); i++)
+    if ( braid[i] != 0 ) data.push_back( braid[i] );
 
 }
 void Strings::getTime( std::vector<double>& data ) {
 
   data.clear();
-  std::copy(t.begin(), t.end(), std::back_inserter(data));
+  data.reserve( braidSize() );
+  for (mwIndex i = 0; i < braid.size(); i++)
+    if ( braid[i] != 0 ) data.push_back( t[i] );
 
 }
 
@@ -842,13 +1572,76 @@ bool Strings::applyCrossing( const PWX& cross ) {
   if (success.first) {
     // generator has a positive sign if left string crosses above the
     // right string
-    braid.push_back( cross.L_On_Top ?
-                     (success.second+1) : (-(success.second+1)) );
-    t.push_back( cross.t );
+    pushGenerator( cross.L_On_Top ?
+                   (success.second+1) : (-(success.second+1)),
+                   cross.t );
   }
   return success.first;
 }
 
+// Append a generator, cancelling it with a previous one if possible.
+void Strings::pushGenerator( int gen, double tgen ) {
+
+  if ( reduce == REDUCE_CANCEL ) {
+    if ( !braid.empty() && braid.back() == -gen ) {
+      braid.pop_back();
+      t.pop_back();
+      return;
+    }
+  }
+  else if ( reduce == REDUCE_COMMUTE ) {
+    // The last generator that gen does not commute with is the last
+    // one of index |gen|-1, |gen| or |gen|+1.
+    const mwIndex g = std::abs(gen);
+    mwIndex last = 0, lastg = 0;
+    for (mwIndex h = g-1; h <= g+1; h++) {
+      if ( !lastOfIndex[h].empty() && lastOfIndex[h].back() + 1 > last ) {
+        last = lastOfIndex[h].back() + 1;
+        lastg = h;
+      }
+    }
+    if ( lastg == g && braid[last-1] == -gen ) {
+      braid[last-1] = 0;
+      lastOfIndex[g].pop_back();
+      cancelled++;
+      // drop the cancelled generators at the end right away
+      while ( !braid.empty() && braid.back() == 0 ) {
+        braid.pop_back();
+        t.pop_back();
+        cancelled--;
+      }
+      if ( cancelled > 1024 && 2*cancelled > braid.size() ) purge();
+      return;
+    }
+    lastOfIndex[g].push_back( braid.size() );
+  }
+
+  braid.push_back( gen );
+  t.push_back( tgen );
+}
+
+void Strings::purge() {
+
+  // new position of each surviving generator
+  std::vector<mwIndex> newPos( braid.size() );
+  mwIndex k = 0;
+  for (mwIndex i = 0; i < braid.size(); i++) {
+    newPos[i] = k;
+    if ( braid[i] != 0 ) {
+      braid[k] = braid[i];
+      t[k] = t[i];
+      k++;
+    }
+  }
+  braid.resize( k );
+  t.resize( k );
+  for (mwIndex g = 0; g < lastOfIndex.size(); g++)
+    for (mwIndex j = 0; j < lastOfIndex[g].size(); j++)
+      lastOfIndex[g][j] = newPos[ lastOfIndex[g][j] ];
+  cancelled = 0;
+
+}
+
 std::pair<bool, mwIndex> Strings::switchByColor( mwIndex L, mwIndex R ) {
 
   // find locations of the string
@@ -868,9 +1661,6 @@ std::pair<bool, mwIndex> Strings::switchByColor( mwIndex L, mwIndex R ) {
     colorToLocation[R] = oL;
     colorToLocation[L] = oR;
 
-    // assert that the swap was performed correctly
-    assertLocationColorSanity();
-
     result.first = true;
     result.second = oL;
   }
@@ -881,13 +1671,30 @@ std::pair<bool, mwIndex> Strings::switchByColor( mwIndex L, mwIndex R ) {
 
 // check and interpolate a crossing between strings I and J at time index ti,
 // i.e., between times t(ti) and t(ti+1)
+template <typename T>
 std::pair<bool,PWX> isCrossing( mwIndex ti, mwIndex I, mwIndex J,
-                           Real3DMatrix& XYtraj, RealVector& t) {
+                                Real3DMatrix<T>& XYtraj,
+                                RealVector<double>& t) {
 
-  bool I_On_Left = ( XYtraj(ti, 0, I) < XYtraj(ti, 0, J) );
+  // (promote to double so single-precision data gives a double tc)
+  StepCoords sI, sJ;
+  sI.X0 = XYtraj(ti, 0, I);  sI.X1 = XYtraj(ti+1, 0, I);
+  sI.Y0 = XYtraj(ti, 1, I);  sI.Y1 = XYtraj(ti+1, 1, I);
+  sJ.X0 = XYtraj(ti, 0, J);  sJ.X1 = XYtraj(ti+1, 0, J);
+  sJ.Y0 = XYtraj(ti, 1, J);  sJ.Y1 = XYtraj(ti+1, 1, J);
+
+  return interpolateCrossing( t(ti), t(ti+1), I, J, sI, sJ );
+}
+
+std::pair<bool,PWX> interpolateCrossing( double t0, double t1,
+                                         mwIndex I, mwIndex J,
+                                         const StepCoords& sI,
+                                         const StepCoords& sJ ) {
+
+  bool I_On_Left = ( sI.X0 < sJ.X0 );
 
   // NO CROSSING: order is the same -- exit the function
-  if ( I_On_Left == (XYtraj(ti+1, 0, I) < XYtraj(ti+1, 0, J)) ) {
+  if ( I_On_Left == (sI.X1 < sJ.X1) ) {
     return std::pair<bool, PWX>( false, PWX() );
   }
 
@@ -895,30 +1702,31 @@ std::pair<bool,PWX> isCrossing( mwIndex ti, mwIndex I, mwIndex J,
 
   // calculate indices of the Left and Right string
   mwIndex L, R;
+  const StepCoords *sL, *sR;
   if (I_On_Left) {
-    L = I;
-    R = J;
+    L = I; sL = &sI;
+    R = J; sR = &sJ;
   }
   else {
-    L = J;
-    R = I;
+    L = J; sL = &sJ;
+    R = I; sR = &sI;
   }
 
   // INTERPOLATE CROSSING POINT
 
   // length of time interval
-  double T = t(ti+1) - t(ti);
+  double dt = t1 - t0;
 
   // differences between two endpoints
-  double dXL = XYtraj(ti+1, 0, L) - XYtraj(ti, 0, L);
-  double dXR = XYtraj(ti+1, 0, R) - XYtraj(ti, 0, R);
-  double dYL = XYtraj(ti+1, 1, L) - XYtraj(ti, 1, L);
-  double dYR = XYtraj(ti+1, 1, R) - XYtraj(ti, 1, R);
+  double dXL = sL->X1 - sL->X0;
+  double dXR = sR->X1 - sR->X0;
+  double dYL = sL->Y1 - sL->Y0;
+  double dYR = sR->Y1 - sR->Y0;
 
   // fraction of the time interval at which the points meet
-  double delta = - ( XYtraj(ti, 0, R) - XYtraj(ti, 0, L) ) / ( dXR - dXL );
+  double delta = - ( sR->X0 - sL->X0 ) / ( dXR - dXL );
 
-  if (sgn<double>(delta) != sgn<double>(T) ) {
+  if (sgn<double>(delta) != sgn<double>(dt) ) {
     PWXexception e("Error in interpolating crossing time."
                    " Interpolated time-point is outside the interval "
                    "determined by input.", L+1, R+1);
@@ -927,9 +1735,9 @@ std::pair<bool,PWX> isCrossing( mwIndex ti, mwIndex I, mwIndex J,
   }
 
   // interpolation
-  double tc = t(ti) + delta * T;
-  double YLc = XYtraj(ti, 1, L) + delta * dYL;
-  double YRc = XYtraj(ti, 1, R) + delta * dYR;
+  double tc = t0 + delta * dt;
+  double YLc = sL->Y0 + delta * dYL;
+  double YRc = sR->Y0 + delta * dYR;
 
   // left string is on top? important for direction of the generator
   bool leftOnTop = YLc > YRc;
@@ -945,21 +1753,36 @@ template <typename T> int sgn(T val) {
 
 // Assert that trajectories I and J are not coincident at time step ti
 // throws PWXexception otherwise
-void assertNotCoincident(const Real3DMatrix& XYtraj, const mwIndex ti,
+template <typename T>
+void assertNotCoincident(const Real3DMatrix<T>& XYtraj, const mwIndex ti,
                          const mwIndex I, const mwIndex J,
                          const double AbsTol)
+{
+  int code = coincidenceCode( double(XYtraj(ti, 0, I)) - double(XYtraj(ti, 0, J)),
+                              double(XYtraj(ti, 1, I)) - double(XYtraj(ti, 1, J)),
+                              AbsTol );
+
+  if ( code == 0 ) return; // no error
+
+  throw coincidenceError( code, ti, I, J );
+}
+
+int coincidenceCode( double dX, double dY, double AbsTol )
 {
   int code = 0;
 
-  if ( std::abs(XYtraj(ti, 0, I) - XYtraj(ti, 0, J)) < AbsTol ) { // X
+  if ( std::abs(dX) < AbsTol ) { // X
     code = 2; // for code explanation, see PWXexception
-    if ( std::abs(XYtraj(ti, 1, I) - XYtraj(ti, 1, J)) < AbsTol ) { // Y
+    if ( std::abs(dY) < AbsTol ) { // Y
       code = 3; // for code explanation, see PWXexception
     }
   }
 
-  if ( code == 0 ) return; // no error
+  return code;
+}
 
+PWXexception coincidenceError( int code, mwIndex ti, mwIndex I, mwIndex J )
+{
   // Construct error message.  Make sure to use Matlab 1-indexing.
   std::stringstream report;
   report << "Particles " << I+1 << " and " << J+1 << " have coincident ";
@@ -975,10 +1798,17 @@ void assertNotCoincident(const Real3DMatrix& XYtraj, const mwIndex ti,
 
   PWXexception e(report.str(), I+1, J+1);
   e.code = code;
-  throw e;
-
-  return;
+  return e;
 }
 
+PWXexception projectionError( const PWXexception& e, size_t k )
+{
+  std::stringstream report;
+  report << e.what() << " (projection angle " << k+1 << ")";
+
+  PWXexception ek(report.str(), e.L, e.R);
+  ek.code = e.code;
+  return ek;
+}
 
 #endif // BRAIDLAB_CROSS2GEN_HELPER_HPP
@@ -0,0 +1,165 @@
+// MEX implementation of the matrix of pairwise crossings of a braid.
+
+// <LICENSE
+//   Braidlab: a Matlab package for analyzing data using braids
+//
+//   https://github.com/jeanluct/braidlab
+//
+//   Copyright (C) 2013-2026  Jean-Luc Thiffeault <jeanluc@math.wisc.edu>
+//                            Marko Budisic          <mbudisic@gmail.com>
+//
+//   This file is part of Braidlab.
+//
+//   Braidlab is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   Braidlab is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
+// LICENSE>
+
+// real GCC feature list:
+// https://gcc.gnu.org/projects/cxx0x.html
+#if ( (defined __GNUC__) && (!defined __clang__) )
+
+#define GCCVERSION (__GNUC__ * 10000            \
+                    + __GNUC_MINOR__ * 100      \
+                    + __GNUC_PATCHLEVEL__)
+
+# if ( (!defined BRAIDLAB_NOTHREADING) &&           \
+       ( GCCVERSION < 40600) ) // less than GCC 4.5
+# define BRAIDLAB_NOTHREADING
+# endif
+#endif // gcc
+
+// CLANG: feature list:
+// https://clang.llvm.org/cxx_status.html
+#if (defined __clang__)
+
+#define CLANGVERSION (__clang_major__ * 10000   \
+                      + __clang_minor__ * 100   \
+                      + __clang_patchlevel__)
+
+# if ( (!defined BRAIDLAB_NOTHREADING) &&               \
+       (CLANGVERSION < 30300) ) // less than Clang 3.3
+# define BRAIDLAB_NOTHREADING
+# endif
+
+#endif // clang
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+#include <functional>
+
+#ifndef BRAIDLAB_NOTHREADING
+#include <future>
+#include "ThreadPool.h" // (c) Jakob Progsch, Václav Zeman
+                        // https://github.com/progschj/ThreadPool
+#endif
+
+#include "mex.h"
+
+// Minimum number of generators per thread.
+#define BRAIDLAB_LINKMATRIX_CHUNK 65536
+
+// Signed crossings between strings of the chunk word[i0..i1), with
+// strings labelled by their position at the start of the chunk.  On
+// return str[p] is the label of the string at position p at the end
+// of the chunk.  Only the entries W[a*n+b] with a < b are filled.
+void linkmatrix_chunk(const int *word, const mwIndex i0, const mwIndex i1,
+                      const mwSize n, std::vector<long long>& W,
+                      std::vector<mwIndex>& str)
+{
+  W.assign(n*n,0);
+  str.resize(n);
+  for (mwIndex p = 0; p < n; p++) str[p] = p;
+
+  for (mwIndex i = i0; i < i1; i++)
+    {
+      const int gen = word[i];
+      const mwIndex ind = (gen >= 0 ? gen : -gen);
+      const mwIndex a = str[ind-1], b = str[ind];
+      if (a < b) W[a*n+b] += (gen >= 0 ? 1 : -1);
+      else       W[b*n+a] += (gen >= 0 ? 1 : -1);
+      std::swap(str[ind-1],str[ind]);
+    }
+}
+
+void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
+{
+  if (nrhs < 2)
+    mexErrMsgIdAndTxt("BRAIDLAB:braid:linkmatrix_helper:badarg",
+                      "Not enough arguments.");
+
+  if (!mxIsInt32(prhs[0]) && !mxIsEmpty(prhs[0]))
+    mexErrMsgIdAndTxt("BRAIDLAB:braid:linkmatrix_helper:badarg",
+                      "word should be an int32 vector.");
+
+  const int *word = (int *)mxGetData(prhs[0]);
+  const mwSize L = mxGetNumberOfElements(prhs[0]);
+  const mwSize n = (mwSize)mxGetScalar(prhs[1]);
+
+  // Optional third argument is the number of threads.
+  size_t Nthreads = 1;
+  if (nrhs > 2) Nthreads = (size_t)std::max(mxGetScalar(prhs[2]),1.);
+  Nthreads = std::max(std::min(Nthreads,(size_t)(L/BRAIDLAB_LINKMATRIX_CHUNK)),
+                      (size_t)1);
+
+  for (mwIndex i = 0; i < L; i++)
+    if (word[i] == 0 || (mwSize)std::abs(word[i]) >= n)
+      mexErrMsgIdAndTxt("BRAIDLAB:braid:linkmatrix_helper:badarg",
+                        "Generator out of range.");
+
+  // Each chunk of the word is processed independently, with its strings
+  // labelled by their position at the start of the chunk.
+  std::vector< std::vector<long long> > Wc(Nthreads);
+  std::vector< std::vector<mwIndex> > strc(Nthreads);
+
+#ifndef BRAIDLAB_NOTHREADING
+  if (Nthreads > 1)
+    {
+      ThreadPool pool(Nthreads);
+      std::vector< std::future<void> > done;
+      for (size_t t = 0; t < Nthreads; t++)
+        done.push_back(pool.enqueue(linkmatrix_chunk,word,
+                                    t*L/Nthreads,(t+1)*L/Nthreads,n,
+                                    std::ref(Wc[t]),std::ref(strc[t])));
+      for (size_t t = 0; t < Nthreads; t++) done[t].get();
+    }
+  else
+#endif
+    linkmatrix_chunk(word,0,L,n,Wc[0],strc[0]);
+
+  // Relabel the chunks by the original strings, using the permutation
+  // of the word before each chunk, and sum them.  This costs O(n^2) per
+  // chunk.
+  std::vector<mwIndex> str(n), next(n);
+  for (mwIndex p = 0; p < n; p++) str[p] = p;
+  std::vector<long long> W(n*n,0);
+  for (size_t t = 0; t < Nthreads; t++)
+    {
+      for (mwIndex a = 0; a < n; a++)
+        for (mwIndex b = a+1; b < n; b++)
+          {
+            const mwIndex sa = std::min(str[a],str[b]);
+            const mwIndex sb = std::max(str[a],str[b]);
+            W[sa*n+sb] += Wc[t][a*n+b];
+          }
+      for (mwIndex p = 0; p < n; p++) next[p] = str[strc[t][p]];
+      str.swap(next);
+    }
+
+  // Output a symmetric matrix of doubles.
+  plhs[0] = mxCreateDoubleMatrix(n,n,mxREAL);
+  double *Wp = mxGetPr(plhs[0]);
+  for (mwIndex a = 0; a < n; a++)
+    for (mwIndex b = 0; b < n; b++)
+      Wp[a + b*n] = (double)W[std::min(a,b)*n+std::max(a,b)];
+}
@@ -25,7 +25,7 @@ function XYr = rotate_data_clockwise(XY,proj)
 %   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
 % LICENSE>
 
-XYr = zeros(size(XY));
+XYr = zeros(size(XY),'like',XY);
 
 XYr(:,1,:) =  cos(proj)*XY(:,1,:) + sin(proj)*XY(:,2,:);
 XYr(:,2,:) = -sin(proj)*XY(:,1,:) + cos(proj)*XY(:,2,:);
@@ -24,8 +24,46 @@
 //   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
 // LICENSE>
 
+// real GCC feature list:
+// https://gcc.gnu.org/projects/cxx0x.html
+#if ( (defined __GNUC__) && (!defined __clang__) )
+
+#define GCCVERSION (__GNUC__ * 10000            \
+                    + __GNUC_MINOR__ * 100      \
+                    + __GNUC_PATCHLEVEL__)
+
+# if ( (!defined BRAIDLAB_NOTHREADING) &&           \
+       ( GCCVERSION < 40600) ) // less than GCC 4.5
+# define BRAIDLAB_NOTHREADING
+# endif
+#endif // gcc
+
+// CLANG: feature list:
+// https://clang.llvm.org/cxx_status.html
+#if (defined __clang__)
+
+#define CLANGVERSION (__clang_major__ * 10000   \
+                      + __clang_minor__ * 100   \
+                      + __clang_patchlevel__)
+
+# if ( (!defined BRAIDLAB_NOTHREADING) &&               \
+       (CLANGVERSION < 30300) ) // less than Clang 3.3
+# define BRAIDLAB_NOTHREADING
+# endif
+
+#endif // clang
 
 #include <utility>
+#include <vector>
+#include <algorithm>
+#include <functional>
+
+#ifndef BRAIDLAB_NOTHREADING
+#include <future>
+#include "ThreadPool.h" // (c) Jakob Progsch, Václav Zeman
+                        // https://github.com/progschj/ThreadPool
+#endif
+
 #include "mex.h"
 
 void printvector( const int *v, int L ) {
@@ -33,6 +71,55 @@ void printvector( const int *v, int L ) {
   printf("\n");
 }
 
+// Subbraids of the subsets sub[k0..k1) of strings (0-based, sorted),
+// in a single pass over the braid word.  Each string has the list of
+// subsets it belongs to, so a generator only visits the subsets that
+// contain one of the two strings it exchanges.  The index of a
+// generator in a subbraid is the number of strings of that subset
+// below it, which costs the size of the subset.
+void subbraid_batch(const int *word, const mwSize L, const mwSize N,
+                    const std::vector< std::vector<mwIndex> >& sub,
+                    const size_t k0, const size_t k1, const bool storeind,
+                    std::vector< std::vector<int> >& bs,
+                    std::vector< std::vector<int> >& is)
+{
+  // memb[s] lists the subsets that contain string s, in increasing order.
+  std::vector< std::vector<size_t> > memb(N);
+  for (size_t k = k0; k < k1; k++)
+    for (size_t j = 0; j < sub[k].size(); j++)
+      memb[sub[k][j]].push_back(k);
+
+  // str[p] is the string at position p, and pos[s] the position of s.
+  std::vector<mwIndex> str(N), pos(N);
+  for (mwIndex p = 0; p < N; p++) { str[p] = p; pos[p] = p; }
+
+  for (mwIndex i = 0; i < L; i++)
+    {
+      const int mygen = word[i];
+      const mwIndex ind = ( mygen >= 0 ? mygen : -mygen );
+      const std::vector<size_t>& ma = memb[str[ind-1]];
+      const std::vector<size_t>& mb = memb[str[ind]];
+
+      // Subsets that contain both strings get a generator.
+      for (size_t ia = 0, ib = 0; ia < ma.size() && ib < mb.size(); )
+        {
+          if (ma[ia] < mb[ib]) { ia++; continue; }
+          if (mb[ib] < ma[ia]) { ib++; continue; }
+          const size_t k = ma[ia];
+          int sgen = 1;
+          for (size_t j = 0; j < sub[k].size(); j++)
+            if (pos[sub[k][j]] < ind-1) sgen++;
+          bs[k].push_back( mygen >= 0 ? sgen : -sgen );
+          if (storeind) is[k].push_back((int)(i+1));
+          ia++; ib++;
+        }
+
+      std::swap( str[ind-1], str[ind] );
+      pos[str[ind-1]] = ind-1;
+      pos[str[ind]] = ind;
+    }
+}
+
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
   const mxArray *p_braid = prhs[0];
@@ -60,24 +147,78 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
       mexErrMsgIdAndTxt("BRAIDLAB:braid:subbraid_helper:badarg",
                         "perm should be int32 row-vectors.");
 
+  // Optional fifth argument is the number of threads, and means that
+  // each row of keepstr is a subset of strings, with cell outputs.
+  const bool batch = (nrhs > 4);
+
   if (!mxIsLogical(p_keepstr) ||
-      (mxGetM(p_keepstr) != 1) )
+      (!batch && mxGetM(p_keepstr) != 1) )
       mexErrMsgIdAndTxt("BRAIDLAB:braid:subbraid_helper:badarg",
                         "keepstr should be logical row-vectors.");
+  if (mxGetN(p_keepstr) != mxGetNumberOfElements(p_perm))
+      mexErrMsgIdAndTxt("BRAIDLAB:braid:subbraid_helper:badarg",
+                        "keepstr and perm should have the same length.");
 
   if (!mxIsLogicalScalar(p_storeind))
       mexErrMsgIdAndTxt("BRAIDLAB:braid:subbraid_helper:badarg",
                         "storeind should be logical scalar.");
 
   const int *word = (int *)mxGetData(p_braid); // braid word
-  int *perm = (int *)mxGetData(p_perm); // store permutations
-  mxLogical *keepstr = mxGetLogicals(p_keepstr); // is string kept?
+  const mxLogical *keepstr = mxGetLogicals(p_keepstr); // is string kept?
   bool storeind = mxIsLogicalScalarTrue(p_storeind); // retain time
 
   // number of generators
   mwSize L = mxGetNumberOfElements( p_braid );
   mwSize N = mxGetNumberOfElements( p_perm );
 
+  if (batch)
+    {
+      size_t Nthreads = (size_t)std::max(mxGetScalar(prhs[4]),1.);
+      const size_t K = mxGetM(p_keepstr);
+      std::vector< std::vector<mwIndex> > sub(K);
+      for (size_t k = 0; k < K; k++)
+        for (mwIndex n = 0; n < N; n++)
+          if (keepstr[k + n*K]) sub[k].push_back(n);
+
+      std::vector< std::vector<int> > bsk(K), isk(K);
+      Nthreads = std::min(Nthreads,K);
+#ifndef BRAIDLAB_NOTHREADING
+      if (Nthreads > 1)
+        {
+          // Each thread walks the word for its own share of subsets.
+          ThreadPool pool(Nthreads);
+          std::vector< std::future<void> > done;
+          for (size_t t = 0; t < Nthreads; t++)
+            done.push_back(pool.enqueue(subbraid_batch,word,L,N,
+                                        std::cref(sub),
+                                        t*K/Nthreads,(t+1)*K/Nthreads,
+                                        storeind,
+                                        std::ref(bsk),std::ref(isk)));
+          for (size_t t = 0; t < Nthreads; t++) done[t].get();
+        }
+      else
+#endif
+        subbraid_batch(word,L,N,sub,0,K,storeind,bsk,isk);
+
+      plhs[0] = mxCreateCellMatrix(1,K);
+      plhs[1] = mxCreateCellMatrix(1,K);
+      for (size_t k = 0; k < K; k++)
+        {
+          mxArray *bk = mxCreateNumericMatrix(1,bsk[k].size(),
+                                              mxINT32_CLASS,mxREAL);
+          std::copy(bsk[k].begin(),bsk[k].end(),(int *)mxGetData(bk));
+          mxSetCell(plhs[0],k,bk);
+          if (storeind)
+            {
+              mxArray *ik = mxCreateNumericMatrix(1,isk[k].size(),
+                                                  mxINT32_CLASS,mxREAL);
+              std::copy(isk[k].begin(),isk[k].end(),(int *)mxGetData(ik));
+              mxSetCell(plhs[1],k,ik);
+            }
+        }
+      return;
+    }
+
   // create output braid of max length
   // output subbraid
   plhs[0] = mxCreateNumericMatrix(1,L,mxINT32_CLASS,mxREAL);
@@ -93,6 +234,15 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
   mwIndex bsL = 0;
   int sgen;
 
+  // kept[n] is true if the strand at position n is kept, and below[n]
+  // is the number of kept strands at positions before n, which is the
+  // index of the strand at n in the subbraid.  A generator only
+  // exchanges the strands at positions ind-1 and ind, so it can only
+  // change below[ind]: each generator costs O(1).
+  std::vector<char> kept( keepstr, keepstr + N );
+  std::vector<mwIndex> below( N+1, 0 );
+  for (mwIndex n = 0; n < N; n++)
+    below[n+1] = below[n] + (kept[n] ? 1 : 0);
 
   // main algorithm loop
   // go through the full braid,
@@ -105,23 +255,9 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     // index of first strand in generator
     ind = ( mygen >= 0 ? mygen : -mygen );
 
-    if ( keepstr[ind-1] && keepstr[ind] ) {
-      // find index of the strand in subset
-      // of strands that is kept
-      sgen = 0;
-      for ( mwIndex n = 0; n < N; n++ ) {
-        if ( !keepstr[n] ) {
-          continue;
-        }
-        else {
-          if ( perm[ind-1] == perm[n] ) {
-            break;
-          }
-          else {
-            sgen++;
-          }
-        }
-      }
+    if ( kept[ind-1] && kept[ind] ) {
+      // index of the strand in the subset of strands that is kept
+      sgen = (int) below[ind-1];
 
       // store subbraid generator and index of crossing
       // in matlab convention
@@ -130,10 +266,11 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
         is[bsL] = (int) (i+1);
       bsL++;
     }
-
-    // update permutation
-    std::swap<int>( perm[ind-1], perm[ind] );
-    std::swap<mxLogical>( keepstr[ind-1], keepstr[ind] );
+    else if ( kept[ind-1] != kept[ind] ) {
+      // update membership permutation
+      std::swap( kept[ind-1], kept[ind] );
+      below[ind] = below[ind-1] + (kept[ind-1] ? 1 : 0);
+    }
   }
 
   mxSetN( plhs[0], bsL );
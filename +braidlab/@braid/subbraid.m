@@ -4,6 +4,12 @@ function [varargout] = subbraid(b,s)
 %   all strings in B but the ones specified in S.  S is a vector which
 %   is a subset of 1:N, where N is the number of strings in the braid.
 %
+%   BS = SUBBRAID(B,S) where S is a cell array of subsets of 1:N returns
+%   a cell array BS of the same size, with BS{K} = SUBBRAID(B,S{K}).  The
+%   braid word is traversed once for all the subsets, split between
+%   threads, which is much faster than separate calls when there are many
+%   small subsets, such as all the pairs or triples of strings.
+%
 %   This is a method for the BRAID class.
 %   See also BRAID.
 
@@ -31,17 +37,14 @@ function [varargout] = subbraid(b,s)
 %   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
 % LICENSE>
 
-if isempty(s)
-  error('BRAIDLAB:braid:subbraid:badstring', ...
-        'Specify some substrings.')
-end
-
-% ensure input is unique and sorted
-s = unique(s);
-
-if min(s) < 1 || max(s) > b.n
-  error('BRAIDLAB:braid:subbraid:badstring', ...
-        'Substring out of range.')
+if iscell(s)
+  if isempty(s)
+    error('BRAIDLAB:braid:subbraid:badstring', ...
+          'Specify some substrings.')
+  end
+  s = cellfun(@(ss) checkstrings(ss,b.n), s, 'UniformOutput', false);
+else
+  s = checkstrings(s,b.n);
 end
 
 %% determine if MEX implementation should be used
@@ -54,16 +57,22 @@ else
   usematlab = true;
 end
 
-nn = length(s);
-
 % keeps colors of strings during permutations as integers
 perm = cast(1:b.n, 'like', b.word);
 
+doesReturnIndex = nargout > 1;
+
+if iscell(s)
+  [varargout{1:max(nargout,1)}] = ...
+      subbraid_batch(b,s,perm,doesReturnIndex,usematlab);
+  return
+end
+
+nn = length(s);
+
 % store membership of p in s, as logicals
 keepstr = ismember(perm, s);
 
-doesReturnIndex = nargout > 1;
-
 %% MEX implementation of algorithm
 if ~usematlab
   try
@@ -92,6 +101,55 @@ varargout{1} = braidlab.braid(bs,nn);
 if nargout > 1, varargout{2} = is; end
 
 
+% =========================================================================
+function s = checkstrings(s,n)
+%% CHECKSTRINGS Validate a subset of strings.
+
+if isempty(s)
+  error('BRAIDLAB:braid:subbraid:badstring', ...
+        'Specify some substrings.')
+end
+
+% ensure input is unique and sorted
+s = unique(s);
+
+if min(s) < 1 || max(s) > n
+  error('BRAIDLAB:braid:subbraid:badstring', ...
+        'Substring out of range.')
+end
+
+% =========================================================================
+function [bsc, isc] = subbraid_batch( b, s, perm, storeind, usematlab )
+%% SUBBRAID_BATCH Subbraids for a cell array of subsets of strings.
+
+% each row of keepstr is the membership of a subset
+keepstr = false(numel(s),b.n);
+for k = 1:numel(s), keepstr(k,s{k}) = true; end
+
+if ~usematlab
+  try
+    [bs, is] = subbraid_helper( b.word, perm, keepstr, storeind, ...
+                                braidlab.util.getAvailableThreadNumber() );
+  catch me
+    warning(me.identifier, [ me.message ...
+                    ' Reverting to Matlab subbraid'] );
+    usematlab = true;
+  end
+end
+
+if usematlab
+  bs = cell(1,numel(s)); is = cell(1,numel(s));
+  for k = 1:numel(s)
+    [bs{k}, is{k}] = subbraid_m( b.word, perm, keepstr(k,:), storeind );
+  end
+end
+
+bsc = cell(size(s)); isc = cell(size(s));
+for k = 1:numel(s)
+  bsc{k} = braidlab.braid(bs{k},length(s{k}));
+  isc{k} = is{k};
+end
+
 % =========================================================================
 function [bs, is] = subbraid_m( word, perm, keepstr, storeind )
 %% SUBBRAID_M Extract generators.
@@ -11,10 +11,14 @@
 %
 %   METHODS('CFBRAID') shows a list of methods.
 %
+%   CFBRAID.NORMALFORMS computes the canonical forms of many braid words
+%   at once, in a flat format.  It can also compute the Birman-Ko-Lee
+%   normal forms, in band generators.
+%
 %   Reference: J. S. Birman and T. E. Brendle, "Braids: A Survey," in
 %   Handbook of Knot Theory (2005), pp. 78-82.
 %
-%   See also BRAID, CFBRAID.CFBRAID.
+%   See also BRAID, CFBRAID.CFBRAID, CFBRAID.NORMALFORMS.
 
 % <LICENSE
 %   Braidlab: a Matlab package for analyzing data using braids
@@ -180,6 +184,64 @@ classdef cfbraid < matlab.mixin.CustomDisplay
       l = abs(b.delta)*Dl + length(cell2mat(b.factors));
     end
 
+    function b12 = mtimes(b1,b2)
+    %MTIMES   Multiply a braid in left canonical form by another braid.
+    %   C = B1*B2, where B1 is a CFBRAID, returns the left canonical form
+    %   of the product of the two braids.  B2 can be a CFBRAID, a BRAID, or
+    %   a list of generators.
+    %
+    %   The factors of B1 are not recomputed: the generators of B2 are
+    %   appended one at a time, and only the last few factors of the form
+    %   change, so this is much faster than CFBRAID([B1.WORD B2.WORD]) when
+    %   B1 is long and B2 is short.  Appending all the generators in one
+    %   product, as in B1*[W1 W2 W3], is faster than several products.
+    %
+    %   This is a method for the CFBRAID class.
+    %   See also CFBRAID, BRAID.MTIMES.
+      if ~isa(b1,'braidlab.cfbraid')
+        error('BRAIDLAB:cfbraid:mtimes:badobject', ...
+              'Cannot multiply a cfbraid on the left by this object.')
+      end
+      if isa(b2,'braidlab.cfbraid'), b2 = braid(b2); end
+      if isa(b2,'braidlab.braid')
+        n2 = b2.n;
+        w = b2.word;
+      elseif isnumeric(b2)
+        w = b2(:).';
+        n2 = max([abs(w)+1 1]);
+      else
+        error('BRAIDLAB:cfbraid:mtimes:badobject', ...
+              'Cannot multiply a cfbraid by this object.')
+      end
+      if any(w == 0)
+        error('BRAIDLAB:cfbraid:mtimes:badgen', ...
+              'A generator is out of range.');
+      end
+      if n2 > b1.n
+        % The product has more strings, so all of its factors change.
+        b12 = braidlab.cfbraid(braid(b1)*braidlab.braid(w,n2));
+        return
+      end
+      cf = cfbraid_helper(int32(w),b1.n,0,b1.delta, ...
+                          cellfun(@int32,b1.factors,'UniformOutput',false));
+      b12 = b1;
+      b12.delta = cf.delta;
+      b12.factors = cf.factors;
+    end
+
+  end % methods block
+
+
+  %
+  % Static methods defined in separate files.
+  %
+  % These methods do not need a cfbraid object as a first argument.
+  %
+  % Need to execute 'clear classes' to register changes here.
+  %
+
+  methods (Static = true)
+    [delta,gen,facptr,brptr] = normalforms(W,n,typ)
   end % methods block
 
 
@@ -1,4 +1,4 @@
-function [varargout] = conjtest(b1,b2)
+function [varargout] = conjtest(b1,b2,method)
 %CONJTEST   Conjugacy test for braids.
 %   ISCONJ = CONJTEST(B1,B2) returns true if B1 and B2 are conjugate
 %   braids, that is, if there exists a braid C such that
@@ -9,6 +9,42 @@ function [varargout] = conjtest(b1,b2)
 %
 %   B1 and B2 must be CFBRAID objects.
 %
+%   CONJTEST(B1,B2,METHOD) chooses the algorithm:
+%
+%     'uss'   the Ultra Summit Set of B1 is searched for B2;
+%     'sc'    the set of sliding circuits of B1 is searched for B2 [1].
+%             It is contained in the Ultra Summit Set, and is often much
+%             smaller, but each of its elements costs more to find;
+%     'bkl'   the super summit set of B1 in the band generators of
+%             Birman, Ko, and Lee [2] is searched for B2, moving
+%             between its elements by minimal positive factors.  The
+%             super summit set is usually much larger than the Ultra
+%             Summit Set, so this is mostly slower than 'uss' and
+%             'sc', and is provided for comparison.  This method
+%             uses a single thread;
+%     'auto'  uses sliding circuits for braids of canonical length at
+%             least 3 that are not rigid, and the Ultra Summit Set
+%             otherwise.
+%
+%   The conjugating braid C can depend on the method.  The default is
+%   'auto' if only ISCONJ is requested, and 'uss' otherwise, so that C
+%   is the same as in earlier versions.
+%
+%   The set is searched breadth-first, and the search stops as soon as
+%   B2 is found.  If several threads are available, the orbits at each
+%   step of the search are expanded in parallel.  The result does not
+%   depend on the number of threads, which can be set with the global
+%   MATLAB variable BRAIDLAB_threads.
+%
+%   References:
+%
+%   [1] V. Gebhardt and J. Gonzalez-Meneses, "The cyclic sliding
+%       operation in Garside groups," Math. Z. 265 (2010), 85-114.
+%
+%   [2] J. S. Birman, K. H. Ko, and S. J. Lee, "A new approach to the
+%       word and conjugacy problems in the braid groups," Adv. Math. 139
+%       (1998), 322-353.
+%
 %   See also CFBRAID.
 
 % <LICENSE
@@ -44,6 +80,16 @@ if ~isa(b1,'braidlab.cfbraid') || ~isa(b2,'braidlab.cfbraid')
         'Function takes two CFBRAIDS as arguments.');
 end
 
+if nargin < 3
+  if nargout > 1, method = 'uss'; else method = 'auto'; end
+end
+methodnames = {'auto','uss','sc','bkl'};
+if ~ischar(method) || ~any(strcmpi(method,methodnames))
+  error('BRAIDLAB:cfbraid:conjtest:badarg', ...
+        'METHOD must be ''auto'', ''uss'', ''sc'' or ''bkl''.');
+end
+method = find(strcmpi(method,methodnames)) - 1;
+
 if b1.n ~= b2.n
   varargout{1} = false;
   if nargout > 1, varargout{2} = []; end
@@ -67,7 +113,8 @@ end
 % TODO: The braids are already in canonical form, but that's recomputed in
 % the helper. Rewrite so the helper function accepts a struct.
 
-[isconj,C] = conjtest_helper(b1.braid.word,b2.braid.word,b1.n);
+[isconj,C] = conjtest_helper(b1.braid.word,b2.braid.word,b1.n, ...
+                             braidlab.util.getAvailableThreadNumber(),method);
 
 varargout{1} = isconj;
 if nargout > 1
@@ -0,0 +1,100 @@
+function [delta,gen,facptr,brptr] = normalforms(W,n,typ)
+%NORMALFORMS   Canonical forms of many braid words.
+%   [DELTA,GEN,FACPTR,BRPTR] = CFBRAID.NORMALFORMS(W) computes the left
+%   canonical forms of the braid words in the cell array W.  W can also be
+%   an array of BRAID objects.  The forms are returned in flat arrays
+%   rather than as CFBRAID objects:
+%
+%     DELTA   DELTA(K) is the power of Delta of the K-th braid;
+%     GEN     int32 row vector of the generators of all the positive
+%             factors, one factor after the other;
+%     FACPTR  factor F is GEN(FACPTR(F):FACPTR(F+1)-1);
+%     BRPTR   the factors of the K-th braid are BRPTR(K):BRPTR(K+1)-1.
+%
+%   Thus the factors of the K-th braid are the same as those of
+%   CFBRAID(W{K}), and two braids are equal if and only if they have the
+%   same DELTA and the same list of factors.
+%
+%   CFBRAID.NORMALFORMS(W,N) specifies the number of strings N of the
+%   braids, which is otherwise deduced from W.
+%
+%   CFBRAID.NORMALFORMS(W,N,'rcf') computes right canonical forms instead,
+%   where DELTA is the power of Delta on the right.  N can be empty.
+%
+%   CFBRAID.NORMALFORMS(W,N,'bkl') computes the Birman-Ko-Lee normal forms
+%   in the band generators
+%
+%     a_ts = (s_(t-1) ... s_(s+1)) s_s (s_(t-1) ... s_(s+1))^-1,  t > s,
+%
+%   where s_i are the Artin generators.  DELTA is then the power of the
+%   band Garside element d = s_(N-1) ... s_1 (with d^N = Delta^2), and GEN
+%   is a 2-row int32 matrix: the band generators of factor F are a_ts
+%   with [t;s] the columns of GEN(:,FACPTR(F):FACPTR(F+1)-1).
+%
+%   Reference: J. S. Birman, K. H. Ko, and S. J. Lee, "A new approach to
+%   the word and conjugacy problems in the braid groups," Adv. Math. 139
+%   (1998), 322-353.
+%
+%   The braids are split between threads.  This is much faster than
+%   creating a CFBRAID for each word when there are many short braids.
+%
+%   This is a static method for the CFBRAID class.
+%   See also CFBRAID, CFBRAID.CFBRAID.
+
+% <LICENSE
+%   Braidlab: a Matlab package for analyzing data using braids
+%
+%   https://github.com/jeanluct/braidlab
+%
+%   Copyright (C) 2013-2026  Jean-Luc Thiffeault <jeanluc@math.wisc.edu>
+%                            Marko Budisic          <mbudisic@gmail.com>
+%
+%   This file is part of Braidlab.
+%
+%   Braidlab is free software: you can redistribute it and/or modify
+%   it under the terms of the GNU General Public License as published by
+%   the Free Software Foundation, either version 3 of the License, or
+%   (at your option) any later version.
+%
+%   Braidlab is distributed in the hope that it will be useful,
+%   but WITHOUT ANY WARRANTY; without even the implied warranty of
+%   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+%   GNU General Public License for more details.
+%
+%   You should have received a copy of the GNU General Public License
+%   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
+% LICENSE>
+
+if nargin < 2, n = []; end
+if nargin < 3, typ = 'lcf'; end
+
+if isa(W,'braidlab.braid')
+  if any([W.n] ~= W(1).n)
+    error('BRAIDLAB:cfbraid:normalforms:badarg', ...
+          'The braids must all have the same number of strings.')
+  end
+  if isempty(n), n = W(1).n; end
+  W = {W.word};
+elseif ~iscell(W)
+  error('BRAIDLAB:cfbraid:normalforms:badarg', ...
+        'W must be a cell array of words or an array of braids.')
+end
+
+typnames = {'lcf','rcf','bkl'};
+if ~ischar(typ) || ~any(strcmpi(typ,typnames))
+  error('BRAIDLAB:cfbraid:normalforms:badarg', ...
+        'Type must be ''lcf'', ''rcf'' or ''bkl''.')
+end
+ityp = find(strcmpi(typ,typnames)) - 1;
+
+W = cellfun(@int32,W,'UniformOutput',false);
+maxgen = max([0 cellfun(@(w) double(max([0 abs(w(:)')])),W(:)')]);
+if isempty(n)
+  n = max(maxgen+1,1);
+elseif n < maxgen+1
+  error('BRAIDLAB:cfbraid:normalforms:badgen', ...
+        'A generator is out of range.');
+end
+
+[delta,gen,facptr,brptr] = ...
+    cfbraid_helper(W,n,ityp,braidlab.util.getAvailableThreadNumber());
@@ -0,0 +1,309 @@
+//
+// Matlab MEX file
+//
+// BAND_HELPER   Birman-Ko-Lee (band generator) normal forms.
+//
+// The band generators are
+//
+//   a_ts = (sigma_(t-1) ... sigma_(s+1)) sigma_s (sigma_(t-1) ... sigma_(s+1))^-1
+//
+// for t > s, and delta = sigma_(n-1) ... sigma_1 = a_(n,n-1) ... a_21 is
+// the Garside element, with delta^n = Delta^2.  The positive factors of
+// the band presentation correspond to non-crossing partitions, so there
+// are only Catalan(n) of them instead of n!.
+//
+// Reference: J. S. Birman, K. H. Ko, and S. J. Lee, "A new approach to
+// the word and conjugacy problems in the braid groups," Adv. Math. 139
+// (1998), 322-353.
+//
+
+// <LICENSE
+//   Braidlab: a Matlab package for analyzing data using braids
+//
+//   https://github.com/jeanluct/braidlab
+//
+//   Copyright (C) 2013-2026  Jean-Luc Thiffeault <jeanluc@math.wisc.edu>
+//                            Marko Budisic          <mbudisic@gmail.com>
+//
+//   This file is part of Braidlab.
+//
+//   Braidlab is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   Braidlab is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
+// LICENSE>
+
+#ifndef BRAIDLAB_BAND_HELPER_HPP
+#define BRAIDLAB_BAND_HELPER_HPP
+
+#include <cstdlib>
+#include <list>
+#include <map>
+#include <vector>
+#include <algorithm>
+#include <functional>
+#include "mex.h"
+#include "cbraid.h"
+
+// Append the band generators of the factor F to gen, as pairs t,s for
+// a_ts, and return their number.  Each cycle t1 > t2 > ... > tk of the
+// permutation of F is the product a_(t1,t2) a_(t2,t3) ... a_(tk-1,tk).
+inline mwSize band_factor_word(const CBraid::BandFactor& F, const int n,
+                               std::vector<int>& gen)
+{
+  const mwSize l0 = gen.size();
+  std::vector<int> u(n+1), c;
+  std::vector<bool> seen(n+1,false);
+  for (int i = 1; i <= n; ++i) u[F[i]] = i;
+  for (int i = n; i >= 1; --i)
+    {
+      if (seen[i]) continue;
+      c.clear();
+      for (int j = i; !seen[j]; j = u[j])
+        {
+          seen[j] = true;
+          c.push_back(j);
+        }
+      std::sort(c.begin(),c.end(),std::greater<int>());
+      for (size_t k = 0; k+1 < c.size(); ++k)
+        {
+          gen.push_back(c[k]);
+          gen.push_back(c[k+1]);
+        }
+    }
+  return (gen.size() - l0)/2;
+}
+
+// Append the Artin word of delta^k to w.
+inline void band_delta_word(const int k, const int n, std::list<int>& w)
+{
+  for (int p = 0; p < std::abs(k); ++p)
+    {
+      if (k > 0)
+        for (int i = n-1; i >= 1; --i) w.push_back(i);
+      else
+        for (int i = 1; i <= n-1; ++i) w.push_back(-i);
+    }
+}
+
+// Convert a braid in band generators to a word in Artin generators.
+inline std::list<int> band_to_artin_word(const CBraid::BandBraid& B)
+{
+  const int n = B.Index();
+  std::list<int> w;
+  std::vector<int> gen;
+  band_delta_word(B.LeftDelta,n,w);
+  for (CBraid::BandBraid::ConstFactorItr it = B.FactorList.begin();
+       it != B.FactorList.end(); ++it)
+    {
+      gen.clear();
+      band_factor_word(*it,n,gen);
+      for (size_t k = 0; k < gen.size(); k += 2)
+        {
+          const int t = gen[k], s = gen[k+1];
+          for (int i = t-1; i > s; --i) w.push_back(i);
+          w.push_back(s);
+          for (int i = s+1; i < t; ++i) w.push_back(-i);
+        }
+    }
+  band_delta_word(B.RightDelta,n,w);
+  return w;
+}
+
+// The left join (least common multiple) of the positive factors a
+// and b.  Left and right divisibility coincide for the positive
+// factors of the band presentation, so c = a v b is such that
+// c^-1 delta = (a^-1 delta) ^ (b^-1 delta).
+inline CBraid::BandFactor band_join(const CBraid::BandFactor& a,
+                                    const CBraid::BandFactor& b)
+{
+  const CBraid::BandFactor D(a.Index(),1);
+  return D*(!(~a).LeftMeet(~b));
+}
+
+// The smallest positive factor u such that A u is a multiple of c,
+// where A = x_1 ... x_r are the factors of the braid B in LCF.  This is
+// u = x_r \ ( ... (x_1 \ c)), with x \ c = x^-1 (x v c).
+inline CBraid::BandFactor band_complement(const CBraid::BandBraid& B,
+                                          CBraid::BandFactor c)
+{
+  for (CBraid::BandBraid::ConstFactorItr it = B.FactorList.begin();
+       it != B.FactorList.end(); ++it)
+    c = (!*it)*band_join(*it,c);
+  return c;
+}
+
+// The smallest positive factor c that is a multiple of s such that
+// (!c)*X*c is in the super summit set, where X is in the super summit
+// set and in LCF, and Xi is the LCF of !X.
+//
+// With X = delta^p A, the infimum of (!c)*X*c is at least p if and only
+// if A c is a multiple of tau^p(c) = delta^-p c delta^p.  Any such c
+// that is a multiple of s is then also a multiple of the complement of
+// tau^p(s) by A, so c is enlarged until it satisfies this, and the same
+// condition for !X (which bounds the supremum).  See Franco and
+// Gonzalez-Meneses, "Conjugacy problem for braid groups and Garside
+// groups," J. Algebra 266 (2003), 112-132.
+inline CBraid::BandFactor band_min_factor(const CBraid::BandBraid& X,
+                                          const CBraid::BandBraid& Xi,
+                                          CBraid::BandFactor c)
+{
+  for (;;)
+    {
+      CBraid::BandFactor d =
+        band_join(c,band_complement(X,c.Flip(X.LeftDelta)));
+      d = band_join(d,band_complement(Xi,d.Flip(Xi.LeftDelta)));
+      if (d == c) return c;
+      c = d;
+    }
+}
+
+// The minimal positive factors conjugating X to the super summit set,
+// one for each band generator a_ts, without repetitions.  X must be in
+// the super summit set and in LCF.  Every element of the super summit
+// set is reached from X by a sequence of such conjugations.
+inline void band_min_factors(const CBraid::BandBraid& X,
+                             std::vector<CBraid::BandFactor>& S)
+{
+  const int n = X.Index();
+  const CBraid::BandBraid Xi = (!X).MakeLCF();
+  S.clear();
+  for (int t = 2; t <= n; ++t)
+    {
+      for (int s = 1; s < t; ++s)
+        {
+          // The factor a_ts transposes t and s.
+          CBraid::BandFactor a(n,0);
+          a[t] = s;
+          a[s] = t;
+          a = band_min_factor(X,Xi,a);
+          if (std::find(S.begin(),S.end(),a) == S.end()) S.push_back(a);
+        }
+    }
+}
+
+// Cycle and decycle B into its super summit set, with (!C)*B*C the
+// result.  B must be in LCF.
+inline CBraid::BandBraid band_send_to_sss(const CBraid::BandBraid& B,
+                                          CBraid::BandBraid& C)
+{
+  using CBraid::BandBraid;
+  using CBraid::BandFactor;
+
+  const int n = B.Index();
+  // If the infimum (resp. supremum) can be increased (resp. decreased),
+  // this happens within ||delta|| = n-1 cyclings (resp. decyclings).
+  const int m = n-1;
+  BandBraid X(B);
+  C = BandBraid(n);
+
+  for (int k = 0; k < m && !X.FactorList.empty(); )
+    {
+      // X = delta^p A R = tau^-p(A) delta^p R is conjugated by
+      // tau^-p(A).  (For Artin braids tau^2 is the identity, so
+      // Braiding uses tau^p.)
+      BandFactor F = X.FactorList.front().Flip(-X.LeftDelta);
+      const CBraid::sint32 inf = X.LeftDelta;
+      X = ((!BandBraid(F))*X*F).MakeLCF();
+      C = C*F;
+      k = (X.LeftDelta > inf ? 0 : k+1);
+    }
+
+  for (int k = 0; k < m && !X.FactorList.empty(); )
+    {
+      BandBraid F(X.FactorList.back());
+      const CBraid::sint32 sup = X.LeftDelta + X.FactorList.size();
+      X = (F*X*(!F)).MakeLCF();
+      C = C*(!F);
+      k = (X.LeftDelta + (CBraid::sint32)X.FactorList.size() < sup ?
+           0 : k+1);
+    }
+
+  C.MakeLCF();
+  return X;
+}
+
+// A key identifying a braid in LCF, to index the super summit set.
+inline std::vector<CBraid::sint16> band_key(const CBraid::BandBraid& B)
+{
+  const int n = B.Index();
+  std::vector<CBraid::sint16> key(1,B.LeftDelta);
+  key.reserve(1 + n*B.FactorList.size());
+  for (CBraid::BandBraid::ConstFactorItr it = B.FactorList.begin();
+       it != B.FactorList.end(); ++it)
+    for (int i = 1; i <= n; ++i) key.push_back((*it)[i]);
+  return key;
+}
+
+// Returns true if B1 and B2 are conjugate, in which case C is set to a
+// braid such that (!C)*B1*C == B2.  The braids must be in LCF.
+//
+// The super summit set of B1 is built breadth-first by conjugating
+// each of its elements by its minimal positive factors, at most
+// n(n-1)/2 of them, and the search stops as soon as B2 is found.
+inline bool band_conjtest(const CBraid::BandBraid& B1,
+                          const CBraid::BandBraid& B2, CBraid::BandBraid& C)
+{
+  using CBraid::BandBraid;
+  using CBraid::BandFactor;
+
+  const int n = B1.Index();
+  BandBraid C1(n), C2(n);
+  BandBraid BT1 = band_send_to_sss(B1,C1), BT2 = band_send_to_sss(B2,C2);
+
+  if (BT1.LeftDelta != BT2.LeftDelta ||
+      BT1.FactorList.size() != BT2.FactorList.size())
+    return false;
+
+  // The k-th braid of the set is (!mins[k])*sss[prev[k]]*mins[k].
+  std::vector<BandBraid> sss(1,BT1);
+  std::vector<BandFactor> mins(1,BandFactor(n,0));
+  std::vector<size_t> prev(1,0);
+  std::map<std::vector<CBraid::sint16>,size_t> index;
+  index[band_key(BT1)] = 0;
+
+  const std::vector<CBraid::sint16> key2 = band_key(BT2);
+  bool conj = (index.count(key2) != 0);
+  size_t found = 0;
+  for (size_t k = 0; k < sss.size() && !conj; ++k)
+    {
+      std::vector<BandFactor> S;
+      band_min_factors(sss[k],S);
+      for (size_t j = 0; j < S.size(); ++j)
+        {
+          BandBraid Y = ((!BandBraid(S[j]))*sss[k]*S[j]).MakeLCF();
+          std::vector<CBraid::sint16> key = band_key(Y);
+          if (index.count(key)) continue;
+          index[key] = sss.size();
+          sss.push_back(Y);
+          mins.push_back(S[j]);
+          prev.push_back(k);
+          if (key == key2)
+            {
+              conj = true;
+              found = sss.size()-1;
+              break;
+            }
+        }
+    }
+
+  if (!conj)
+    return false;
+
+  BandBraid D(n);
+  for (size_t k = found; k != 0; k = prev[k])
+    D.LeftMultiply(mins[k]);
+
+  C = (C1*D*(!C2)).MakeLCF();
+  return true;
+}
+
+#endif // BRAIDLAB_BAND_HELPER_HPP
@@ -28,41 +28,269 @@
 //   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
 // LICENSE>
 
+#if ( (defined __GNUC__) && (!defined __clang__) )
+#define GCCVERSION (__GNUC__ * 10000            \
+                    + __GNUC_MINOR__ * 100      \
+                    + __GNUC_PATCHLEVEL__)
+# if ( (!defined BRAIDLAB_NOTHREADING) &&           \
+       ( GCCVERSION < 40600) ) // less than GCC 4.5
+# define BRAIDLAB_NOTHREADING
+# endif
+#endif // gcc
+
+#if (defined __clang__)
+#define CLANGVERSION (__clang_major__ * 10000   \
+                      + __clang_minor__ * 100   \
+                      + __clang_patchlevel__)
+# if ( (!defined BRAIDLAB_NOTHREADING) &&               \
+       (CLANGVERSION < 30300) ) // less than Clang 3.3
+# define BRAIDLAB_NOTHREADING
+# endif
+#endif // clang
+
 #include <iostream>
 #include <cmath>
 #include <list>
+#include <vector>
+#include <algorithm>
+#include <functional>
 #include "mex.h"
 #include "braiding.h"
+#include "band_helper.hpp"
+
+#ifndef BRAIDLAB_NOTHREADING
+#include <future>
+#include "ThreadPool.h" // (c) Jakob Progsch, Václav Zeman
+                        // https://github.com/progschj/ThreadPool
+#endif
 
 
 extern void _main();
 
+// Normal forms of the words [k0,k1) of a batch: the power of Delta of
+// each braid, its number of factors, and the length and generators of
+// each factor, in order.  For band normal forms the power is of delta,
+// the length is the number of band generators a_ts, and gen holds the
+// pairs t,s.
+struct NormalForms
+{
+  std::vector<int> delta;
+  std::vector<mwSize> nfac, faclen;
+  std::vector<int> gen;
+};
+
+// Append the generators of the positive factor F to gen, and return
+// their number.  (See Juan's braiding.cpp.)
+mwSize factor_word(CBraid::ArtinFactor F, const int n, std::vector<int>& gen)
+{
+  const mwSize l0 = gen.size();
+  for (int i = 2; i <= n; ++i)
+    {
+      for (int j = i; j > 1 && F[j] < F[j-1]; --j)
+        {
+          gen.push_back(j-1);
+          std::swap(F[j],F[j-1]);
+        }
+    }
+  return gen.size() - l0;
+}
+
+// The factor sigma_i, or its complement ~sigma_i = sigma_i^-1 Delta
+// if i is negative, so that sigma_i^-1 = ~sigma_i Delta^-1.
+CBraid::ArtinFactor generator_factor(const int i, const int n)
+{
+  CBraid::ArtinFactor F(n,0);
+  std::swap(F[std::abs(i)],F[std::abs(i)+1]);
+  return (i > 0 ? F : ~F);
+}
+
+void normal_forms(const std::vector<const int *>& w,
+                  const std::vector<mwSize>& N, const int n, const int ityp,
+                  const size_t k0, const size_t k1, NormalForms& nf)
+{
+  std::list<int> bw;
+  for (size_t k = k0; k < k1; ++k)
+    {
+      bw.assign(w[k],w[k]+N[k]);
+      if (ityp == 2)
+        {
+          CBraid::BandBraid
+            B(CBraid::ToBandBraid(Braiding::WordToBraid(bw,n)));
+          B.MakeLCF();
+          nf.delta.push_back(B.LeftDelta);
+          nf.nfac.push_back(B.FactorList.size());
+          for(CBraid::BandBraid::ConstFactorItr it = B.FactorList.begin();
+              it != B.FactorList.end(); ++it)
+            {
+              nf.faclen.push_back(band_factor_word(*it,n,nf.gen));
+            }
+          continue;
+        }
+      CBraid::ArtinBraid B(Braiding::WordToBraid(bw,n));
+      if (ityp != 0) B.MakeRCF();
+
+      nf.delta.push_back(ityp == 0 ? B.LeftDelta : B.RightDelta);
+      nf.nfac.push_back(B.FactorList.size());
+      for(CBraid::ArtinBraid::ConstFactorItr it = B.FactorList.begin();
+          it != B.FactorList.end(); ++it)
+        {
+          nf.faclen.push_back(factor_word(*it,n,nf.gen));
+        }
+    }
+}
+
 void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 {
   using std::cout;
   using std::endl;
 
-  // Arguments checked and formatted in cfbraid.m.
+  // Arguments checked and formatted in cfbraid.m or normalforms.m.
+
+  if (mxIsCell(prhs[0]))
+    {
+      // Batch mode: a cell array of words, with the number of threads
+      // as a fourth argument.  The output is flat:
+      //
+      //  delta    the power of Delta of each braid;
+      //  gen      the generators of all the factors, one after the other
+      //           (for band forms, a 2-row matrix of the pairs t,s);
+      //  facptr   factor f is gen(facptr(f):facptr(f+1)-1);
+      //  brptr    braid k has factors brptr(k):brptr(k+1)-1.
+      //
+      const size_t K = mxGetNumberOfElements(prhs[0]);
+      const int n = (int)mxGetScalar(prhs[1]);
+      const int ityp = (int)mxGetScalar(prhs[2]);
+      size_t Nthreads = 1;
+      if (nrhs > 3) Nthreads = (size_t)std::max(mxGetScalar(prhs[3]),1.);
+      Nthreads = std::max(std::min(Nthreads,K),(size_t)1);
+
+      std::vector<const int *> w(K);
+      std::vector<mwSize> N(K);
+      for (size_t k = 0; k < K; ++k)
+        {
+          const mxArray *wA = mxGetCell(prhs[0],k);
+          if (wA == 0 || (!mxIsInt32(wA) && !mxIsEmpty(wA)))
+            mexErrMsgIdAndTxt("BRAIDLAB:cfbraid:cfbraid_helper:badarg",
+                              "Words should be int32 vectors.");
+          w[k] = (const int *)mxGetData(wA);
+          N[k] = mxGetNumberOfElements(wA);
+          for (mwIndex i = 0; i < N[k]; ++i)
+            if (w[k][i] == 0 || std::abs(w[k][i]) >= n)
+              mexErrMsgIdAndTxt("BRAIDLAB:cfbraid:cfbraid_helper:badgen",
+                                "A generator is out of range.");
+        }
+
+      std::vector<NormalForms> nf(Nthreads);
+#ifndef BRAIDLAB_NOTHREADING
+      if (Nthreads > 1)
+        {
+          ThreadPool pool(Nthreads);
+          std::vector< std::future<void> > done;
+          for (size_t t = 0; t < Nthreads; t++)
+            done.push_back(pool.enqueue(normal_forms,std::cref(w),
+                                        std::cref(N),n,ityp,
+                                        t*K/Nthreads,(t+1)*K/Nthreads,
+                                        std::ref(nf[t])));
+          for (size_t t = 0; t < Nthreads; t++) done[t].get();
+        }
+      else
+#endif
+        normal_forms(w,N,n,ityp,0,K,nf[0]);
+
+      mwSize Ftot = 0, Gtot = 0;
+      for (size_t t = 0; t < Nthreads; t++)
+        {
+          Ftot += nf[t].faclen.size();
+          Gtot += nf[t].gen.size();
+        }
+
+      plhs[0] = mxCreateDoubleMatrix(1,K,mxREAL);
+      if (ityp == 2)
+        plhs[1] = mxCreateNumericMatrix(2,Gtot/2,mxINT32_CLASS,mxREAL);
+      else
+        plhs[1] = mxCreateNumericMatrix(1,Gtot,mxINT32_CLASS,mxREAL);
+      plhs[2] = mxCreateDoubleMatrix(1,Ftot+1,mxREAL);
+      plhs[3] = mxCreateDoubleMatrix(1,K+1,mxREAL);
+      double *delta = mxGetPr(plhs[0]);
+      int *gen = (int *)mxGetData(plhs[1]);
+      double *facptr = mxGetPr(plhs[2]), *brptr = mxGetPr(plhs[3]);
+
+      facptr[0] = 1; brptr[0] = 1;
+      for (size_t t = 0; t < Nthreads; t++)
+        {
+          delta = std::copy(nf[t].delta.begin(),nf[t].delta.end(),delta);
+          gen = std::copy(nf[t].gen.begin(),nf[t].gen.end(),gen);
+          for (size_t f = 0; f < nf[t].faclen.size(); ++f, ++facptr)
+            facptr[1] = facptr[0] + nf[t].faclen[f];
+          for (size_t k = 0; k < nf[t].nfac.size(); ++k, ++brptr)
+            brptr[1] = brptr[0] + nf[t].nfac[k];
+        }
+      return;
+    }
 
   const mxArray *wA = prhs[0];
   const int *w = (int *)mxGetData(wA); // wA contains int32's.
-  const mwSize N = std::max(mxGetM(wA),mxGetN(wA));
+  const mwSize N = mxGetNumberOfElements(wA);
   int n = (int)mxGetScalar(prhs[1]);
   int ityp = (int)mxGetScalar(prhs[2]);
 
-  // Convert braid word to list.
-  std::list<int> bw;
-  for (mwIndex i = 0; i < N; ++i) bw.push_back(w[i]);
-
-  CBraid::ArtinBraid B(Braiding::WordToBraid(bw,n));
+  CBraid::ArtinBraid B(n);
 
-  if (ityp == 0)
+  if (nrhs > 4)
     {
-      B.MakeLCF();
+      // Append mode: the word is multiplied on the right of the left
+      // canonical form given by the power of Delta prhs[3] and the
+      // factors prhs[4].  Only the end of the form is made left-weighted
+      // again as each generator is appended.
+      B.LeftDelta = (int)mxGetScalar(prhs[3]);
+      const mxArray *facA = prhs[4];
+      for (mwIndex f = 0; f < mxGetNumberOfElements(facA); ++f)
+        {
+          const mxArray *gA = mxGetCell(facA,f);
+          const int *g = (int *)mxGetData(gA); // gA contains int32's.
+          CBraid::ArtinFactor F(n,0);
+          for (mwIndex i = 0; i < mxGetNumberOfElements(gA); ++i)
+            F *= generator_factor(g[i],n);
+          B.FactorList.push_back(F);
+        }
+
+      for (mwIndex i = 0; i < N; ++i)
+        {
+          B.RightMultiplyLCF(generator_factor(w[i],n));
+          if (w[i] < 0) --B.RightDelta;
+        }
+
+      // Move the Delta's to the left.  This does not change the
+      // left-weightedness of the factors, so MakeLCF isn't needed (and
+      // would make the whole form left-weighted again).  The form is
+      // always an LCF in append mode.
+      if (B.RightDelta != 0)
+        {
+          for(CBraid::ArtinBraid::FactorItr it = B.FactorList.begin();
+              it != B.FactorList.end(); ++it)
+            {
+              *it = it->Flip(B.RightDelta);
+            }
+          B.LeftDelta += B.RightDelta;
+          B.RightDelta = 0;
+        }
     }
   else
     {
-      B.MakeRCF();
+      // Convert braid word to list.
+      std::list<int> bw;
+      for (mwIndex i = 0; i < N; ++i) bw.push_back(w[i]);
+
+      B = Braiding::WordToBraid(bw,n);
+
+      if (ityp == 0)
+        {
+          B.MakeLCF();
+        }
+      else
+        {
+          B.MakeRCF();
+        }
     }
 
 #ifdef BRAIDLAB_MEX_DEBUG
@@ -96,33 +324,18 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
     }
   mxSetFieldByNumber(plhs[0],0,3,mxCreateDoubleScalar(n));
   mwIndex fac = 0;
-  for(std::list<CBraid::ArtinFactor>::iterator it = B.FactorList.begin();
+  for(CBraid::ArtinBraid::FactorItr it = B.FactorList.begin();
       it != B.FactorList.end(); ++it, ++fac)
     {
-      // Extract the generators from each factor:
-      // (see Juan's braiding.cpp)
-      CBraid::ArtinFactor F = *it;
-      std::list<int> wn;
-      for (int i = 2; i <= n; ++i)
-        {
-          for (int j = i; j > 1 && F[j] < F[j-1]; --j)
-            {
+      // Extract the generators from each factor.
+      std::vector<int> wn;
+      factor_word(*it,n,wn);
 #ifdef BRAIDLAB_MEX_DEBUG
-              cout << j-1 << " ";
+      for (size_t k = 0; k < wn.size(); ++k) cout << wn[k] << " ";
 #endif
-              wn.push_back(j-1);
-              std::swap(F[j],F[j-1]);
-            }
-        }
-      // Now copy list wn to an mxArray.
+      // Now copy wn to an mxArray.
       mxArray *wnA = mxCreateNumericMatrix(1,wn.size(),mxINT32_CLASS,mxREAL);
-      int *wnp = (int *)mxGetPr(wnA);
-      mwIndex k = 0;
-      for (std::list<int>::const_iterator it2 = wn.begin();
-           it2 != wn.end(); ++it2, ++k)
-        {
-          wnp[k] = *it2;
-        }
+      std::copy(wn.begin(),wn.end(),(int *)mxGetData(wnA));
       // And then assign this mxArray to a cell element.
       mxSetCell(factors,fac,wnA);
     }
@@ -31,8 +31,11 @@
 #include <iostream>
 #include <cmath>
 #include <list>
+#include <algorithm>
 #include "mex.h"
 #include "braiding.h"
+#include "conjtest_helper.hpp"
+#include "band_helper.hpp"
 
 
 extern void _main();
@@ -53,6 +56,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
 
   int n = (int)mxGetScalar(prhs[2]);
 
+  // Optional fourth argument is the number of threads.
+  size_t Nthreads = 1;
+  if (nrhs > 3) Nthreads = (size_t)std::max(mxGetScalar(prhs[3]),1.);
+
+  // Optional fifth argument is the method (see conjtest_helper.hpp).
+  int method = (nrhs > 4 ? (int)mxGetScalar(prhs[4]) : CONJTEST_USS);
+
   // Convert braid words to list.
   std::list<int> bw1, bw2;
   for (mwIndex i = 0; i < N1; ++i) bw1.push_back(w1[i]);
@@ -65,7 +75,22 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
   B1.MakeLCF();
   B2.MakeLCF();
 
-  bool conj = Braiding::AreConjugate(B1,B2,C);
+  if (method == CONJTEST_AUTO) method = conjtest_method(B1);
+
+  bool conj;
+  if (method == CONJTEST_BKL)
+    {
+      CBraid::BandBraid BB1(CBraid::ToBandBraid(B1));
+      CBraid::BandBraid BB2(CBraid::ToBandBraid(B2));
+      CBraid::BandBraid BC(n);
+      conj = band_conjtest(BB1.MakeLCF(),BB2.MakeLCF(),BC);
+      // CBraid's ToArtinBraid is not reliable, so go through a word.
+      if (conj) C = Braiding::WordToBraid(band_to_artin_word(BC),n);
+    }
+  else if (method == CONJTEST_SC)
+    conj = conjtest<SlidingCircuitsSet>(B1,B2,C,Nthreads);
+  else
+    conj = conjtest<UltraSummitSet>(B1,B2,C,Nthreads);
 
   plhs[0] = mxCreateLogicalScalar(conj);
 
@@ -93,7 +118,7 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[])
   mxSetFieldByNumber(plhs[1],0,1,mxCreateDoubleScalar(C.LeftDelta));
   mxSetFieldByNumber(plhs[1],0,3,mxCreateDoubleScalar(n));
   mwIndex fac = 0;
-  for(std::list<CBraid::ArtinFactor>::iterator it = C.FactorList.begin();
+  for(CBraid::ArtinBraid::FactorItr it = C.FactorList.begin();
       it != C.FactorList.end(); ++it, ++fac)
     {
       // Extract the generators from each factor:
@@ -0,0 +1,289 @@
+//
+// Matlab MEX file
+//
+// CONJTEST   Conjugacy test for two braid words.
+//
+// The summit set of the first braid is built breadth-first, one level
+// at a time.  The orbits in a level are expanded in parallel, and the
+// new orbits are then merged in order, so the summit set and the
+// conjugating braid do not depend on the number of threads.  The
+// search stops as soon as the second braid is found.
+//
+
+// <LICENSE
+//   Braidlab: a Matlab package for analyzing data using braids
+//
+//   https://github.com/jeanluct/braidlab
+//
+//   Copyright (C) 2013-2026  Jean-Luc Thiffeault <jeanluc@math.wisc.edu>
+//                            Marko Budisic          <mbudisic@gmail.com>
+//
+//   This file is part of Braidlab.
+//
+//   Braidlab is free software: you can redistribute it and/or modify
+//   it under the terms of the GNU General Public License as published by
+//   the Free Software Foundation, either version 3 of the License, or
+//   (at your option) any later version.
+//
+//   Braidlab is distributed in the hope that it will be useful,
+//   but WITHOUT ANY WARRANTY; without even the implied warranty of
+//   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//   GNU General Public License for more details.
+//
+//   You should have received a copy of the GNU General Public License
+//   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
+// LICENSE>
+
+#ifndef BRAIDLAB_CONJTEST_HELPER_HPP
+#define BRAIDLAB_CONJTEST_HELPER_HPP
+
+#if ( (defined __GNUC__) && (!defined __clang__) )
+#define GCCVERSION (__GNUC__ * 10000            \
+                    + __GNUC_MINOR__ * 100      \
+                    + __GNUC_PATCHLEVEL__)
+# if ( (!defined BRAIDLAB_NOTHREADING) &&           \
+       ( GCCVERSION < 40600) ) // less than GCC 4.5
+# define BRAIDLAB_NOTHREADING
+# endif
+#endif // gcc
+
+#if (defined __clang__)
+#define CLANGVERSION (__clang_major__ * 10000   \
+                      + __clang_minor__ * 100   \
+                      + __clang_patchlevel__)
+# if ( (!defined BRAIDLAB_NOTHREADING) &&               \
+       (CLANGVERSION < 30300) ) // less than Clang 3.3
+# define BRAIDLAB_NOTHREADING
+# endif
+#endif // clang
+
+#include <list>
+#include <deque>
+#include <vector>
+#include "braiding.h"
+
+#ifndef BRAIDLAB_NOTHREADING
+#include <future>
+#include "ThreadPool.h" // (c) Jakob Progsch, Václav Zeman
+                        // https://github.com/progschj/ThreadPool
+#endif
+
+// Minimum number of orbits in a level for it to be expanded in parallel.
+#define BRAIDLAB_CONJTEST_MINLEVEL 4
+
+// The Ultra Summit Set, as used by Braiding::AreConjugate.
+struct UltraSummitSet
+{
+  static CBraid::ArtinBraid Send(const CBraid::ArtinBraid& B,
+                                 CBraid::ArtinBraid& C)
+  {
+    return Braiding::SendToUSS(B,C);
+  }
+
+  // The first orbit, as in Braiding::USS.
+  static std::list<CBraid::ArtinBraid> First(const CBraid::ArtinBraid& B)
+  {
+    std::list<CBraid::ArtinBraid> T =
+      Braiding::Trajectory(Braiding::SendToUSS(B));
+    return Braiding::Trajectory(Braiding::Cycling(T.back()));
+  }
+
+  static std::list<CBraid::ArtinFactor> Min(const CBraid::ArtinBraid& B)
+  {
+    return Braiding::MinUSS(B);
+  }
+
+  static std::list<CBraid::ArtinBraid> Orbit(const CBraid::ArtinBraid& B)
+  {
+    return Braiding::Trajectory(B);
+  }
+
+  // Conjugates an element of an orbit to the next one.
+  static CBraid::ArtinFactor Step(const CBraid::ArtinBraid& B)
+  {
+    return B.FactorList.front().Flip(B.LeftDelta);
+  }
+};
+
+// The Set of Sliding Circuits, as used by Braiding::AreConjugateSC.
+struct SlidingCircuitsSet
+{
+  static CBraid::ArtinBraid Send(const CBraid::ArtinBraid& B,
+                                 CBraid::ArtinBraid& C)
+  {
+    return Braiding::SendToSC(B,C);
+  }
+
+  // The first orbit, as in Braiding::SC.
+  static std::list<CBraid::ArtinBraid> First(const CBraid::ArtinBraid& B)
+  {
+    return Braiding::Trajectory_Sliding(Braiding::SendToSC(B));
+  }
+
+  static std::list<CBraid::ArtinFactor> Min(const CBraid::ArtinBraid& B)
+  {
+    return Braiding::MinSC(B);
+  }
+
+  static std::list<CBraid::ArtinBraid> Orbit(const CBraid::ArtinBraid& B)
+  {
+    return Braiding::Trajectory_Sliding(B);
+  }
+
+  // Conjugates an element of a circuit to the next one.
+  static CBraid::ArtinFactor Step(const CBraid::ArtinBraid& B)
+  {
+    return Braiding::PreferredPrefix(B);
+  }
+};
+
+// Conjugacy test methods.  CONJTEST_BKL uses the super summit set in
+// the band generators (see band_helper.hpp).
+enum { CONJTEST_AUTO = 0, CONJTEST_USS = 1, CONJTEST_SC = 2,
+       CONJTEST_BKL = 3 };
+
+// Choose the method for the automatic mode.  For rigid braids the
+// sliding circuits are the same as the Ultra Summit Set, which is
+// cheaper to build, and for short braids both sets are small.  But for
+// longer braids that are not rigid the Ultra Summit Set can be much
+// larger than the set of sliding circuits.
+inline int conjtest_method(const CBraid::ArtinBraid& B)
+{
+  CBraid::ArtinBraid BT = Braiding::SendToUSS(B);
+  const CBraid::sint16 cl = Braiding::CL(BT);
+  if (cl >= 3 && Braiding::Rigidity(BT) < cl) return CONJTEST_SC;
+  return CONJTEST_USS;
+}
+
+// Conjugates of the first element of an orbit by its minimal simple
+// elements, and the orbits of those that were not in the summit set
+// at the start of the level (the others have an empty orbit).
+struct OrbitExpansion
+{
+  std::vector<CBraid::ArtinFactor> F;
+  std::vector<CBraid::ArtinBraid> B;
+  std::vector< std::list<CBraid::ArtinBraid> > T;
+};
+
+template<class Summit>
+void expand_orbit(const CBraid::ArtinBraid& B,
+                  const Braiding::SummitIndex& index, OrbitExpansion& ex)
+{
+  std::list<CBraid::ArtinFactor> Min = Summit::Min(B);
+  ex.F.assign(Min.begin(),Min.end());
+  ex.B.reserve(ex.F.size());
+  ex.T.resize(ex.F.size());
+  for (size_t j = 0; j < ex.F.size(); ++j)
+    {
+      ex.B.push_back(((!CBraid::ArtinBraid(ex.F[j]))*B*ex.F[j]).MakeLCF());
+      if (index.Find(ex.B[j]) == 0) ex.T[j] = Summit::Orbit(ex.B[j]);
+    }
+}
+
+// Returns true if B1 and B2 are conjugate, in which case C is set to a
+// braid such that (!C)*B1*C == B2.  The braids must be in LCF.
+template<class Summit>
+bool conjtest(const CBraid::ArtinBraid& B1, const CBraid::ArtinBraid& B2,
+              CBraid::ArtinBraid& C, const size_t Nthreads)
+{
+  using CBraid::ArtinBraid;
+  using CBraid::ArtinFactor;
+  using CBraid::sint32;
+
+  const CBraid::sint16 n = B1.Index();
+  ArtinBraid C1(n), C2(n);
+  ArtinBraid BT1 = Summit::Send(B1,C1), BT2 = Summit::Send(B2,C2);
+
+  if (Braiding::CL(BT1) != Braiding::CL(BT2) ||
+      Braiding::Sup(BT1) != Braiding::Sup(BT2))
+    return false;
+
+  if (Braiding::CL(BT1) == 0)
+    {
+      C = (C1*(!C2)).MakeLCF();
+      return true;
+    }
+
+  // The orbits are kept in a deque, so that the braids referenced by
+  // the index never move.  The first element of orbit k is obtained by
+  // conjugating the first element of orbit prev[k] by mins[k].
+  std::deque< std::list<ArtinBraid> > orbits;
+  std::vector<ArtinFactor> mins;
+  std::vector<sint32> prev;
+  Braiding::SummitIndex index;
+
+  orbits.push_back(Summit::First(BT1));
+  index.Insert(orbits.back(),1);
+  mins.push_back(ArtinFactor(n,0));
+  prev.push_back(0);
+
+  sint32 found = index.Find(BT2);
+
+  // Orbits [begin,end) form the current level of the search.
+  size_t begin = 0;
+  while (found == 0 && begin < orbits.size())
+    {
+      const size_t end = orbits.size();
+      std::vector<OrbitExpansion> ex(end-begin);
+
+#ifndef BRAIDLAB_NOTHREADING
+      if (Nthreads > 1 && end-begin >= BRAIDLAB_CONJTEST_MINLEVEL)
+        {
+          // The index is only read while the level is expanded.
+          ThreadPool pool(Nthreads);
+          std::vector< std::future<void> > done;
+          for (size_t i = begin; i < end; ++i)
+            {
+              done.push_back(pool.enqueue(expand_orbit<Summit>,
+                                          std::cref(orbits[i].front()),
+                                          std::cref(index),
+                                          std::ref(ex[i-begin])));
+            }
+          for (size_t i = 0; i < done.size(); ++i) done[i].get();
+        }
+      else
+#endif
+        {
+          for (size_t i = begin; i < end; ++i)
+            expand_orbit<Summit>(orbits[i].front(),index,ex[i-begin]);
+        }
+
+      // Merge the new orbits in order, as the serial search would.
+      for (size_t i = begin; i < end && found == 0; ++i)
+        {
+          OrbitExpansion& e = ex[i-begin];
+          for (size_t j = 0; j < e.B.size(); ++j)
+            {
+              if (e.T[j].empty() || index.Find(e.B[j]) != 0) continue;
+              orbits.push_back(std::list<ArtinBraid>());
+              orbits.back().swap(e.T[j]);
+              index.Insert(orbits.back(),(sint32)orbits.size());
+              mins.push_back(e.F[j]);
+              prev.push_back((sint32)i);
+              if ((found = index.Find(BT2)) != 0) break;
+            }
+        }
+
+      begin = end;
+    }
+
+  if (found == 0)
+    return false;
+
+  // Conjugate the first orbit to the first element of the orbit of BT2,
+  // and then along that orbit.
+  ArtinBraid D1(n), D2(n);
+  for (size_t k = found-1; k != 0; k = prev[k])
+    D1.LeftMultiply(mins[k]);
+
+  const std::list<ArtinBraid>& orbit = orbits[found-1];
+  for (std::list<ArtinBraid>::const_iterator it = orbit.begin();
+       *it != BT2; ++it)
+    D2 = D2*Summit::Step(*it);
+
+  C = (C1*D1*D2*(!C2)).MakeLCF();
+
+  return true;
+}
+
+#endif // BRAIDLAB_CONJTEST_HELPER_HPP
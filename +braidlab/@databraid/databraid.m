@@ -59,6 +59,11 @@ classdef databraid < braidlab.braid
     %   line with angle PROJANG (in radians) from the X axis to determine
     %   crossings.  The default is to project onto the X axis (PROJANG = 0).
     %
+    %   Back-and-forth crossings of jittering particles can be cancelled as
+    %   the databraid is constructed, keeping the crossing times of the
+    %   other generators, by setting the braidlab property BraidReduce to
+    %   'cancel' or 'commute' (see BRAIDLAB.PROP).
+    %
     %   DATABRAID(BB,T) creates a databraid from a braid BB and crossing
     %   times T.  T defaults to [1:length(BB)].
     %
@@ -215,7 +220,12 @@ classdef databraid < braidlab.braid
       % Use the optional return argument ii for braid.subbraid, which gives
       % a list of the generators that were kept.
       [bb,ii] = subbraid@braidlab.braid(b,s);
-      bs = braidlab.databraid(bb,b.tcross(ii));
+      if iscell(bb)
+        bs = cellfun(@(bk,ik) braidlab.databraid(bk,b.tcross(ik)), ...
+                     bb,ii,'UniformOutput',false);
+      else
+        bs = braidlab.databraid(bb,b.tcross(ii));
+      end
     end
 
   end % methods block
@@ -10,9 +10,11 @@ function XYc = closure(XY,ctype)
 %   that is, such that the strings return to their initial position.
 %
 %   XYC = CLOSURE(XY,'MinDist') closes the trajectories to minimize the sum
-%   of the Euclidean distances between the final and initial points.  This
-%   uses Markus Buehren's implementation of the Hungarian algorithm for the
-%   optimal assigment problem.
+%   of the Euclidean distances between the final and initial points.  The
+%   MEX version solves this optimal assignment problem with an auction
+%   algorithm that starts from the nearest neighbors of each point, so the
+%   full matrix of distances is never formed.  Without MEX, this uses
+%   Markus Buehren's implementation of the Hungarian algorithm.
 %   (https://www.mathworks.com/matlabcentral/fileexchange/6543-functions-for-the-rectangular-assignment-problem)
 %
 %   XYC = CLOSURE(XY,PERM) closes the braid so that final points are
@@ -82,6 +84,15 @@ else
     XYnew(1,:,I0) = XY(1,:,I0);
 
    case 'mindist'
+    try
+      [~,XYc] = braidlab.util.closure_helper(XY, ...
+                  braidlab.util.getAvailableThreadNumber());
+      return
+    catch me
+      if isempty(regexpi(me.identifier, 'BRAIDLAB:NoMEX', 'once'))
+        rethrow(me);
+      end
+    end
     n = size(XY,3);
     X0 = XY(1,:,:);
     X1 = XY(end,:,:);
@@ -35,6 +35,15 @@ function [varargout] = prop(varargin)
 %   coincident coordinates when constructing a braid from data.  Set this to
 %   a conservative estimate of typical errors in your dataset.
 %
+%   * BraidReduce [{'none'} | 'cancel' | 'commute'] - How the generators
+%   are reduced as they are found when constructing a braid from data.
+%   With 'cancel', a generator that is the inverse of the one just before
+%   it cancels with it, as it does for the back-and-forth crossings of
+%   jittering particles.  With 'commute', it also cancels with an inverse
+%   generator separated from it by commuting generators.  The braid is
+%   unchanged, but is much shorter for noisy data.  A DATABRAID keeps the
+%   crossing times of the remaining generators.
+%
 %   * LoopCoordsBasePoint ['left' | {'right'} | 'dehornoy'] - The position
 %   of the basepoint when defining the loop coordinates of a braid using
 %   braid.loopcoords.  The option 'dehornoy' sets the basepoint to 'left'
@@ -95,6 +104,8 @@ if nargin == 1
     varargout{1} = pr.BraidPlotDir;
    case {'braidabstol'}
     varargout{1} = pr.BraidAbsTol;
+   case {'braidreduce'}
+    varargout{1} = pr.BraidReduce;
    case {'loopcoordsbasepoint'}
     varargout{1} = pr.LoopCoordsBasePoint;
    otherwise
@@ -111,6 +122,8 @@ parser.addParameter('genplotoverunder', [], @(x) x == true || x == false);
 parser.addParameter('braidplotdir', [], @(s) ischar(s) && ...
                    any(strcmpi(s,{'bt','tb','lr','rl'})));
 parser.addParameter('braidabstol', [], @(x) x >= 0);
+parser.addParameter('braidreduce', [], @(s) ischar(s) && ...
+                   any(strcmpi(s,{'none','cancel','commute'})));
 parser.addParameter('loopcoordsbasepoint', [], @(s) ischar(s) && ...
                    any(strcmpi(s,{'left','right','dehornoy'})));
 
@@ -133,6 +146,9 @@ end
 if ~isempty(params.braidabstol)
   pr.BraidAbsTol = params.braidabstol;
 end
+if ~isempty(params.braidreduce)
+  pr.BraidReduce = lower(params.braidreduce);
+end
 if ~isempty(params.loopcoordsbasepoint)
   if strcmpi(params.loopcoordsbasepoint,'dehornoy')
     pr.LoopCoordsBasePoint = 'left';
@@ -161,4 +177,5 @@ pr.GenLoopActDir = 'lr';
 pr.GenPlotOverUnder = true;
 pr.BraidPlotDir = 'bt';
 pr.BraidAbsTol = 1e-10;
+pr.BraidReduce = 'none';
 pr.LoopCoordsBasePoint = 'right';
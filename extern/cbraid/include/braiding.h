@@ -23,10 +23,18 @@
 */
 
 
+#ifndef _braiding_h_
+#define _braiding_h_
+
 #include "cbraid.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#if __cplusplus >= 201103L
+#include <unordered_map>
+#else
+#include <map>
+#endif
 
 
 namespace Braiding {
@@ -34,6 +42,7 @@ namespace Braiding {
 using CBraid::ArtinBraid;
 using CBraid::ArtinFactor;
 using CBraid::sint16;
+using CBraid::sint32;
 using std::list;
 
 ///////////////////////////////////////////////////////
@@ -43,7 +52,7 @@ using std::list;
 //
 ///////////////////////////////////////////////////////
 
-sint16  CL(ArtinBraid B);
+sint16  CL(const ArtinBraid& B);
 
 
 ///////////////////////////////////////////////////////
@@ -53,7 +62,7 @@ sint16  CL(ArtinBraid B);
 //
 ///////////////////////////////////////////////////////
 
-sint16  Sup(ArtinBraid B);
+sint16  Sup(const ArtinBraid& B);
 
 
 ///////////////////////////////////////////////////////
@@ -97,7 +106,7 @@ ArtinBraid WordToBraid(list<sint16> w, sint16 n);
 //
 /////////////////////////////////////////////////////////////
 
-void PrintBraidWord(ArtinBraid B);
+void PrintBraidWord(const ArtinBraid& B);
 
 
 /////////////////////////////////////////////////////////////
@@ -107,7 +116,7 @@ void PrintBraidWord(ArtinBraid B);
 //
 /////////////////////////////////////////////////////////////
 
-void PrintBraidWord(ArtinBraid B, char * file);
+void PrintBraidWord(const ArtinBraid& B, char * file);
 
 
 /////////////////////////////////////////////////////////////
@@ -138,7 +147,7 @@ void PrintWord(list<sint16> & word, sint16 n, sint16 power, char * file);
 //
 /////////////////////////////////////////////////////////////
 
-sint16 ** Crossing(list<sint16> word, sint16 n, sint16 power, sint16 ** cross);
+void Crossing(list<sint16> word, sint16 n, sint16 power, sint16 ** cross);
 
 
 /////////////////////////////////////////////////////////////
@@ -170,7 +179,7 @@ ArtinBraid SendToSSS(ArtinBraid B, ArtinBraid & C);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor LeftWedge(ArtinFactor F1, ArtinFactor F2);
+ArtinFactor LeftWedge(const ArtinFactor& F1, const ArtinFactor& F2);
 
 
 /////////////////////////////////////////////////////////////
@@ -181,7 +190,7 @@ ArtinFactor LeftWedge(ArtinFactor F1, ArtinFactor F2);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor RightWedge(ArtinFactor F1, ArtinFactor F2);
+ArtinFactor RightWedge(const ArtinFactor& F1, const ArtinFactor& F2);
 
 
 /////////////////////////////////////////////////////////////
@@ -192,7 +201,7 @@ ArtinFactor RightWedge(ArtinFactor F1, ArtinFactor F2);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor Remainder(ArtinBraid B, ArtinFactor F);
+ArtinFactor Remainder(const ArtinBraid& B, const ArtinFactor& F);
 
 
 /////////////////////////////////////////////////////////////
@@ -225,7 +234,7 @@ ArtinBraid LeftWedge(ArtinBraid B1, ArtinBraid B2);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor MinSS(ArtinBraid B, ArtinFactor F);
+ArtinFactor MinSS(const ArtinBraid& B, const ArtinFactor& F);
 
 
 /////////////////////////////////////////////////////////////
@@ -236,7 +245,7 @@ ArtinFactor MinSS(ArtinBraid B, ArtinFactor F);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor MinSSS(ArtinBraid B, ArtinFactor F);
+ArtinFactor MinSSS(const ArtinBraid& B, const ArtinFactor& F);
 
 
 /////////////////////////////////////////////////////////////
@@ -247,7 +256,52 @@ ArtinFactor MinSSS(ArtinBraid B, ArtinFactor F);
 //
 /////////////////////////////////////////////////////////////
 
-list<ArtinFactor> MinSSS(ArtinBraid B);
+list<ArtinFactor> MinSSS(const ArtinBraid& B);
+
+
+/////////////////////////////////////////////////////////////
+//
+//  Hash(B)  Computes a hash value of a braid B from its powers of
+//           Delta and the permutations of its factors.  Equal braids
+//           in the same normal form have the same hash value.
+//
+/////////////////////////////////////////////////////////////
+
+std::size_t Hash(const ArtinBraid& B);
+
+
+/////////////////////////////////////////////////////////////
+//
+//  SummitIndex  A hashed index of the braids in a list of orbits
+//               (a SSS, USS or SC), which finds the orbit containing
+//               a braid in constant expected time.  Orbits are numbered
+//               from 1, as in 'prev'.  The braids are not copied, so
+//               they must stay in place while the index is in use.
+//
+/////////////////////////////////////////////////////////////
+
+class SummitIndex {
+
+public:
+  SummitIndex() {}
+  SummitIndex(const list<list<ArtinBraid> > & orbits);
+
+  // Add a braid, or all the braids of an orbit, with orbit number k.
+  void Insert(const ArtinBraid & B, sint32 k);
+  void Insert(const list<ArtinBraid> & T, sint32 k);
+
+  // The orbit number of B, or 0 if B is not in the index.
+  sint32 Find(const ArtinBraid & B) const;
+
+private:
+  typedef std::pair<const ArtinBraid*, sint32> Entry;
+#if __cplusplus >= 201103L
+  typedef std::unordered_multimap<std::size_t, Entry> Table;
+#else
+  typedef std::multimap<std::size_t, Entry> Table;
+#endif
+  Table Braids;
+};
 
 
 /////////////////////////////////////////////////////////////
@@ -256,7 +310,7 @@ list<ArtinFactor> MinSSS(ArtinBraid B);
 //
 /////////////////////////////////////////////////////////////
 
-list<ArtinBraid> SSS(ArtinBraid B);
+list<ArtinBraid> SSS(const ArtinBraid& B);
 
 
 /////////////////////////////////////////////////////////////
@@ -277,7 +331,7 @@ list<ArtinBraid > Trajectory(ArtinBraid B);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinBraid SendToUSS(ArtinBraid B);
+ArtinBraid SendToUSS(const ArtinBraid& B);
 
 
 /////////////////////////////////////////////////////////////
@@ -288,7 +342,7 @@ ArtinBraid SendToUSS(ArtinBraid B);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinBraid SendToUSS(ArtinBraid B, ArtinBraid & C);
+ArtinBraid SendToUSS(const ArtinBraid& B, ArtinBraid & C);
 
 
 /////////////////////////////////////////////////////////////
@@ -299,7 +353,7 @@ ArtinBraid SendToUSS(ArtinBraid B, ArtinBraid & C);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor Transport(ArtinBraid B, ArtinFactor F);
+ArtinFactor Transport(const ArtinBraid& B, const ArtinFactor& F);
 
 
 /////////////////////////////////////////////////////////////
@@ -311,7 +365,7 @@ ArtinFactor Transport(ArtinBraid B, ArtinFactor F);
 //
 /////////////////////////////////////////////////////////////
 
-list<ArtinFactor> Returns(ArtinBraid B, ArtinFactor F);
+list<ArtinFactor> Returns(const ArtinBraid& B, const ArtinFactor& F);
 
 
 /////////////////////////////////////////////////////////////
@@ -321,7 +375,7 @@ list<ArtinFactor> Returns(ArtinBraid B, ArtinFactor F);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor Pullback(ArtinBraid B, ArtinFactor F);
+ArtinFactor Pullback(const ArtinBraid& B, const ArtinFactor& F);
 
 
 /////////////////////////////////////////////////////////////
@@ -332,7 +386,7 @@ ArtinFactor Pullback(ArtinBraid B, ArtinFactor F);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor MainPullback(ArtinBraid B, ArtinFactor F);
+ArtinFactor MainPullback(const ArtinBraid& B, const ArtinFactor& F);
 
 
 /////////////////////////////////////////////////////////////
@@ -343,7 +397,7 @@ ArtinFactor MainPullback(ArtinBraid B, ArtinFactor F);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor MinUSS(ArtinBraid B, ArtinFactor F);
+ArtinFactor MinUSS(const ArtinBraid& B, const ArtinFactor& F);
 
 
 /////////////////////////////////////////////////////////////
@@ -354,7 +408,7 @@ ArtinFactor MinUSS(ArtinBraid B, ArtinFactor F);
 //
 /////////////////////////////////////////////////////////////
 
-list<ArtinFactor> MinUSS(ArtinBraid B);
+list<ArtinFactor> MinUSS(const ArtinBraid& B);
 
 
 /////////////////////////////////////////////////////////////
@@ -363,7 +417,7 @@ list<ArtinFactor> MinUSS(ArtinBraid B);
 //
 /////////////////////////////////////////////////////////////
 
-list<list<ArtinBraid> > USS(ArtinBraid B);
+list<list<ArtinBraid> > USS(const ArtinBraid& B);
 
 
 /////////////////////////////////////////////////////////////
@@ -377,8 +431,20 @@ list<list<ArtinBraid> > USS(ArtinBraid B);
 //
 /////////////////////////////////////////////////////////////
 
-list<list<ArtinBraid> > USS(ArtinBraid B,
-			    list<ArtinFactor> & mins, list<sint16> & prev);
+list<list<ArtinBraid> > USS(const ArtinBraid& B,
+			    list<ArtinFactor> & mins, list<sint32> & prev);
+
+
+/////////////////////////////////////////////////////////////
+//
+//  USS(B,uss,mins,prev,index)  As USS(B,mins,prev), but the Ultra
+//                              Summit Set is stored in uss, and
+//                              indexed in 'index'.
+//
+/////////////////////////////////////////////////////////////
+
+void USS(const ArtinBraid& B, list<list<ArtinBraid> > & uss,
+	 list<ArtinFactor> & mins, list<sint32> & prev, SummitIndex & index);
 
 
 /////////////////////////////////////////////////////////////
@@ -389,8 +455,20 @@ list<list<ArtinBraid> > USS(ArtinBraid B,
 //
 /////////////////////////////////////////////////////////////
 
-ArtinBraid   TreePath(ArtinBraid B, list<list<ArtinBraid> > & uss,
-		      list<ArtinFactor> & mins, list<sint16> & prev);
+ArtinBraid   TreePath(const ArtinBraid& B, list<list<ArtinBraid> > & uss,
+		      list<ArtinFactor> & mins, list<sint32> & prev);
+
+
+/////////////////////////////////////////////////////////////
+//
+//  TreePath(B,uss,mins,prev,index)  As TreePath(B,uss,mins,prev),
+//                                   using the index of the uss.
+//
+/////////////////////////////////////////////////////////////
+
+ArtinBraid   TreePath(const ArtinBraid& B, list<list<ArtinBraid> > & uss,
+		      list<ArtinFactor> & mins, list<sint32> & prev,
+		      const SummitIndex & index);
 
 
 /////////////////////////////////////////////////////////////
@@ -401,7 +479,7 @@ ArtinBraid   TreePath(ArtinBraid B, list<list<ArtinBraid> > & uss,
 //
 /////////////////////////////////////////////////////////////
 
-bool AreConjugate(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C);
+bool AreConjugate(const ArtinBraid& B1, const ArtinBraid& B2, ArtinBraid & C);
 
 
 /////////////////////////////////////////////////////////////
@@ -412,7 +490,7 @@ bool AreConjugate(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C);
 /////////////////////////////////////////////////////////////
 
 list<ArtinBraid> Centralizer(list<list<ArtinBraid> > & uss,
-			     list<ArtinFactor> & mins, list<sint16> & prev);
+			     list<ArtinFactor> & mins, list<sint32> & prev);
 
 
 /////////////////////////////////////////////////////////////
@@ -421,7 +499,7 @@ list<ArtinBraid> Centralizer(list<list<ArtinBraid> > & uss,
 //
 /////////////////////////////////////////////////////////////
 
-list<ArtinBraid> Centralizer(ArtinBraid B);
+list<ArtinBraid> Centralizer(const ArtinBraid& B);
 
 
 /////////////////////////////////////////////////////////////
@@ -431,7 +509,7 @@ list<ArtinBraid> Centralizer(ArtinBraid B);
 //
 /////////////////////////////////////////////////////////////
 
-void Tableau(ArtinFactor F, sint16 **& tab);
+void Tableau(const ArtinFactor& F, sint16 **& tab);
 
 
 /////////////////////////////////////////////////////////////
@@ -577,7 +655,7 @@ char * FileName(sint16 iteration, sint16 max_iteration, sint16 type,
 /////////////////////////////////////////////////////////////
 
 
-ArtinBraid RightMeet(ArtinBraid B1, ArtinBraid B2);
+ArtinBraid RightMeet(const ArtinBraid& B1, const ArtinBraid& B2);
 
 
 
@@ -600,7 +678,7 @@ ArtinBraid LeftJoin(ArtinBraid B1, ArtinBraid B2);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinBraid RightJoin(ArtinBraid B1, ArtinBraid B2);
+ArtinBraid RightJoin(const ArtinBraid& B1, const ArtinBraid& B2);
 
 
 ///////////////////////////////////////////////////////
@@ -610,7 +688,7 @@ ArtinBraid RightJoin(ArtinBraid B1, ArtinBraid B2);
 //
 ///////////////////////////////////////////////////////
 
-ArtinFactor  InitialFactor(ArtinBraid B);
+ArtinFactor  InitialFactor(const ArtinBraid& B);
 
 ///////////////////////////////////////////////////////
 //
@@ -619,7 +697,7 @@ ArtinFactor  InitialFactor(ArtinBraid B);
 //
 ///////////////////////////////////////////////////////
 
-ArtinFactor  PreferredPrefix(ArtinBraid B);
+ArtinFactor  PreferredPrefix(const ArtinBraid& B);
 
 
 ///////////////////////////////////////////////////////
@@ -638,7 +716,7 @@ ArtinFactor  PreferredPrefix(ArtinBraid B);
 //
 ///////////////////////////////////////////////////////
 
-ArtinFactor  PreferredSuffix(ArtinBraid B);
+ArtinFactor  PreferredSuffix(const ArtinBraid& B);
 
 
 /////////////////////////////////////////////////////////////
@@ -669,7 +747,7 @@ list<ArtinBraid > Trajectory_Sliding(ArtinBraid B, ArtinBraid & C, sint16 & d);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinBraid SendToSC(ArtinBraid B);
+ArtinBraid SendToSC(const ArtinBraid& B);
 
 
 /////////////////////////////////////////////////////////////
@@ -681,7 +759,7 @@ ArtinBraid SendToSC(ArtinBraid B);
 /////////////////////////////////////////////////////////////
 
 
-ArtinBraid SendToSC(ArtinBraid B, ArtinBraid & C);
+ArtinBraid SendToSC(const ArtinBraid& B, ArtinBraid & C);
 
 
 /////////////////////////////////////////////////////////////
@@ -691,7 +769,7 @@ ArtinBraid SendToSC(ArtinBraid B, ArtinBraid & C);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor Transport_Sliding(ArtinBraid B, ArtinFactor F);
+ArtinFactor Transport_Sliding(const ArtinBraid& B, const ArtinFactor& F);
 
 
 /////////////////////////////////////////////////////////////
@@ -703,7 +781,7 @@ ArtinFactor Transport_Sliding(ArtinBraid B, ArtinFactor F);
 /////////////////////////////////////////////////////////////
 
 
-list<ArtinFactor> Returns_Sliding(ArtinBraid B, ArtinFactor F); 
+list<ArtinFactor> Returns_Sliding(const ArtinBraid& B, ArtinFactor F); 
 
 
 
@@ -715,7 +793,7 @@ list<ArtinFactor> Returns_Sliding(ArtinBraid B, ArtinFactor F);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor Pullback_Sliding(ArtinBraid B, ArtinFactor F);
+ArtinFactor Pullback_Sliding(const ArtinBraid& B, const ArtinFactor& F);
 
 
 
@@ -727,7 +805,7 @@ ArtinFactor Pullback_Sliding(ArtinBraid B, ArtinFactor F);
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor MainPullback_Sliding(ArtinBraid B, ArtinFactor F);
+ArtinFactor MainPullback_Sliding(const ArtinBraid& B, const ArtinFactor& F);
 
 // Mara Cumplido Cabello
 
@@ -742,7 +820,7 @@ ArtinFactor MainPullback_Sliding(ArtinBraid B, ArtinFactor F);
 
 
 
-ArtinFactor MinSC(ArtinBraid B, ArtinFactor F);
+ArtinFactor MinSC(const ArtinBraid& B, const ArtinFactor& F);
 
 
 
@@ -754,7 +832,7 @@ ArtinFactor MinSC(ArtinBraid B, ArtinFactor F);
 //
 /////////////////////////////////////////////////////////////
 
-list<ArtinFactor> MinSC(ArtinBraid B);
+list<ArtinFactor> MinSC(const ArtinBraid& B);
 
 
 /////////////////////////////////////////////////////////////
@@ -764,7 +842,7 @@ list<ArtinFactor> MinSC(ArtinBraid B);
 /////////////////////////////////////////////////////////////
 
 
-list<list<ArtinBraid> > SC(ArtinBraid B);
+list<list<ArtinBraid> > SC(const ArtinBraid& B);
 
 
 /////////////////////////////////////////////////////////////
@@ -780,7 +858,19 @@ list<list<ArtinBraid> > SC(ArtinBraid B);
 
 
 
-list<list<ArtinBraid> > SC(ArtinBraid B, list<ArtinFactor> & mins, list<sint16> & prev);
+list<list<ArtinBraid> > SC(const ArtinBraid& B, list<ArtinFactor> & mins, list<sint32> & prev);
+
+
+/////////////////////////////////////////////////////////////
+//
+//  SC(B,sc,mins,prev,index)  As SC(B,mins,prev), but the Set of
+//                            Sliding Circuits is stored in sc, and
+//                            indexed in 'index'.
+//
+/////////////////////////////////////////////////////////////
+
+void SC(const ArtinBraid& B, list<list<ArtinBraid> > & sc,
+	list<ArtinFactor> & mins, list<sint32> & prev, SummitIndex & index);
 
 
 ////////////////////////////////////////////////////////////////////////////////////////
@@ -801,7 +891,7 @@ void PrintSC(list<list<ArtinBraid> > &  sc, list<sint16> word, sint16 n,
 //
 //////////////////////////////////////////////////////////////////////////////////
 
-bool AreConjugateSC(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C);
+bool AreConjugateSC(const ArtinBraid& B1, const ArtinBraid& B2, ArtinBraid & C);
 
 
 
@@ -814,7 +904,7 @@ bool AreConjugateSC(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C);
 //////////////////////////////////////////////////////////////////////////////////
 
 
-bool AreConjugateSC2(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C);
+bool AreConjugateSC2(const ArtinBraid& B1, const ArtinBraid& B2, ArtinBraid & C);
 
 
 
@@ -822,3 +912,5 @@ bool AreConjugateSC2(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C);
 
 
 } // namespace Braiding
+
+#endif // _braiding_h_
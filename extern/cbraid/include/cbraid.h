@@ -34,6 +34,8 @@
 #include <algorithm>
 #include <functional>
 #include <list>
+#include <deque>
+#include <utility>
 
 #include <iostream>
 #include <cstdlib>
@@ -110,6 +110,71 @@ inline typename Seq::difference_type erase_back_if(Seq& s, UnaPre f)
 }
 
 
+inline RandomGenerator::RandomGenerator(uint64 seed)
+{
+    Seed(seed);
+}
+
+
+inline void RandomGenerator::Seed(uint64 seed)
+{
+    // Fill the state with splitmix64, so that it is never all zero
+    // and similar seeds give unrelated sequences.
+    for(int i = 0; i < 4; ++i) {
+        uint64 z = (seed += 0x9e3779b97f4a7c15ULL);
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        State[i] = z ^ (z >> 31);
+    }
+}
+
+
+inline uint64 RandomGenerator::operator()()
+{
+    uint64* s = State;
+    uint64 x = s[1]*5;
+    uint64 r = ((x << 7) | (x >> 57))*9;
+    uint64 t = s[1] << 17;
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = (s[3] << 45) | (s[3] >> 19);
+    return r;
+}
+
+
+inline uint64 RandomGenerator::Uniform(uint64 m)
+{
+    // Reject the lowest (2^64 mod m) values, so that there is no bias.
+    uint64 t = (0-m) % m, x;
+    do {
+        x = (*this)();
+    } while (x < t);
+    return x % m;
+}
+
+
+inline void RandomGenerator::Jump()
+{
+    static const uint64 J[4] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL,
+        0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+    };
+    uint64 s[4] = { 0, 0, 0, 0 };
+    for(int i = 0; i < 4; ++i)
+        for(int b = 0; b < 64; ++b) {
+            if (J[i] & (1ULL << b))
+                for(int k = 0; k < 4; ++k)
+                    s[k] ^= State[k];
+            (*this)();
+        }
+    for(int k = 0; k < 4; ++k)
+        State[k] = s[k];
+}
+
+
 inline ArtinPresentation::ArtinPresentation(sint16 n)
 {
 
@@ -139,14 +204,19 @@ inline sint16 ArtinPresentation::DeltaTable(sint16 i, sint32 k) const
 
 inline void ArtinPresentation::Randomize(sint16* r) const
 {
-    // The present implementation generates a random permutation using
-    // rand() function of C library. A better pseudo random number
-    // generator could be used.
+    Randomize(r, DefaultRandomGenerator());
+}
+
+
+inline void ArtinPresentation::Randomize(sint16* r,
+                                         RandomGenerator& g) const
+{
+    // A uniformly random permutation, by the Fisher-Yates shuffle.
 
     for(sint16 i = 1; i <= Index(); ++i)
         r[i] = i;
     for(sint16 i = 1; i < Index(); ++i) {
-        sint16 j = i+sint16(std::rand()/(RAND_MAX+1.0)*(Index()-i+1));
+        sint16 j = i+sint16(g.Uniform(Index()-i+1));
         sint16 z = r[i];
         r[i] = r[j];
         r[j] = z;
@@ -157,7 +227,14 @@ inline void ArtinPresentation::Randomize(sint16* r) const
 inline void ArtinPresentation::LeftMeet(
     const sint16* a, const sint16* b, sint16* r) const
 {
-    static sint16 s[MaxBraidIndex];
+#ifdef USE_BITSET_MEET
+    if (Index() <= BitsetMeetIndex) {
+        BitsetMeetSub(a, b, r, Index());
+        return;
+    }
+#endif
+
+    sint16 s[MaxBraidIndex];
 
     for(sint16 i = 1; i <= Index(); ++i)
         s[i] = i;
@@ -170,12 +247,22 @@ inline void ArtinPresentation::LeftMeet(
 inline void ArtinPresentation::RightMeet(
     const sint16* a, const sint16* b, sint16* r) const
 {
-    static sint16 u[MaxBraidIndex], v[MaxBraidIndex];
+    sint16 u[MaxBraidIndex], v[MaxBraidIndex];
 
     for(sint16 i = 1; i <= Index(); ++i) {
         u[a[i]] = i;
         v[b[i]] = i;
     }
+#ifdef USE_BITSET_MEET
+    // The right meet is the inverse of the left meet of the inverses.
+    if (Index() <= BitsetMeetIndex) {
+        sint16 w[MaxBraidIndex];
+        BitsetMeetSub(u, v, w, Index());
+        for(sint16 i = 1; i <= Index(); ++i)
+            r[w[i]] = i;
+        return;
+    }
+#endif
     for(sint16 i = 1; i <= Index(); ++i)
         r[i] = i;
     MeetSub(u, v, r, 1, Index());
@@ -230,7 +317,7 @@ inline void BandPresentation::PTtoDCDT(const sint16* a, sint16* x) const
 
 inline void BandPresentation::DCDTtoPT(const sint16* x, sint16* a) const
 {
-    static sint16 z[MaxBraidIndex];
+    sint16 z[MaxBraidIndex];
 
     for(sint16 i = 1; i <= Index(); ++i)
         z[i] = 0;
@@ -243,7 +330,7 @@ inline void BandPresentation::DCDTtoPT(const sint16* x, sint16* a) const
 
 inline void BandPresentation::BStoPT(const sint8* s, sint16* a) const
 {
-    static sint16 stack[MaxBraidIndex];
+    sint16 stack[MaxBraidIndex];
     sint16 sp = 0;
 
 //    cout << flush << "BStoPT: ";
@@ -269,29 +356,44 @@ inline void BandPresentation::BStoPT(const sint8* s, sint16* a) const
 }
 
 
-#ifdef USE_CLN
 inline void BandPresentation::Randomize(sint16* r) const
 {
+    Randomize(r, DefaultRandomGenerator());
+}
 
-    static sint8 s[MaxBraidIndex];
-    static sint16 a[MaxBraidIndex];
-    cln::cl_I k =
-        cln::random_I(cln::default_random_state, GetCatalanNumber(Index()))+1;
-    BallotSequence(Index(), k, s);
-    BStoPT(s, a);
-    for(sint16 i = 1; i <= Index(); ++i)
-        r[a[i]] = i;
 
-#else
-inline void BandPresentation::Randomize(sint16*) const
+inline void BandPresentation::Randomize(sint16* r,
+                                        RandomGenerator& g) const
 {
-
-    std::cerr << std::flush
-         << "! BandPresentation::Randomize(): CLN is required.\n"
-         << std::flush;
-    exit(1);
-
-#endif
+    // Shuffle n up-steps and n+1 down-steps.  Exactly one rotation of
+    // this sequence has all its proper partial sums nonnegative: the
+    // one starting after the first minimum of the partial sums.
+    // Dropping its last (down) step gives a ballot sequence, and each
+    // ballot sequence arises from the same number of arrangements.
+    const sint16 n = Index(), m = 2*n+1;
+    sint8 u[2*MaxBraidIndex+1], s[2*MaxBraidIndex+1];
+    sint16 a[MaxBraidIndex+1];
+    for(sint16 i = 0; i < m; ++i)
+        u[i] = (i < n) ? 1 : -1;
+    for(sint16 i = m-1; i > 0; --i) {
+        sint16 j = sint16(g.Uniform(i+1));
+        sint8 z = u[i];
+        u[i] = u[j];
+        u[j] = z;
+    }
+    sint16 h = 0, hmin = 0, k = 0;
+    for(sint16 i = 0; i < m; ++i) {
+        h += u[i];
+        if (h < hmin) {
+            hmin = h;
+            k = i+1;
+        }
+    }
+    for(sint16 i = 1; i <= 2*n; ++i)
+        s[i] = u[(k+i-1) % m];
+    BStoPT(s, a);
+    for(sint16 i = 1; i <= n; ++i)
+        r[a[i]] = i;
 }
  
 
@@ -312,7 +414,7 @@ public:
 inline void BandPresentation::LeftMeet(
     const sint16* a, const sint16* b, sint16* r) const
 {
-    static sint16 x[MaxBraidIndex], y[MaxBraidIndex], u[MaxBraidIndex];
+    sint16 x[MaxBraidIndex], y[MaxBraidIndex], u[MaxBraidIndex];
     sint16 i, j, k;
 
     for(i = 1; i <= Index(); ++i)
@@ -327,27 +429,29 @@ inline void BandPresentation::LeftMeet(
 
     // Here we need to sort u[i] such that (x[u[i]], y[u[i]], u[i]) is
     // decreasing w.r.t. the lexcographic order.  In order to maximize
-    // speed, we use a radix sorting algorithm that uses an workspace
-    // array of size n(n+1).  It would be reduced to 2n by using a
-    // list-based radix sorting, which sacrificing speed.
+    // speed, we use a radix sorting algorithm.  Each pass is a stable
+    // counting sort, with a workspace of size 2n on the stack, so that
+    // this function is reentrant.
 
 #ifdef BAND_PRESENTATION_SORT_BY_COMPARISON
     std::sort(u+1, u+Index()+1, Compare(x, y));
 #else
     for(sint16* z = x; z; z = (z == x) ? y : 0) {
-        static sint16 N[MaxBraidIndex], P[MaxBraidIndex][MaxBraidIndex];
+        sint16 N[MaxBraidIndex], w[MaxBraidIndex];
         for(k = 1; k <= Index(); ++k)
             N[k] = 0;
-        for(i = 1; i <= Index(); ++i) {
-            k = z[u[i]];
-            P[k][N[k]++] = u[i];
-        }
-        i = 1;
-        for(k = Index(); k >= 1; --k) {
-            for(j = 0; j < N[k]; ++j) {
-                u[i++] = P[k][j];
-            }
+        for(i = 1; i <= Index(); ++i)
+            ++N[z[u[i]]];
+        // N[k] becomes the position of the first u[i] with z[u[i]] = k.
+        for(j = 1, k = Index(); k >= 1; --k) {
+            sint16 c = N[k];
+            N[k] = j;
+            j += c;
         }
+        for(i = 1; i <= Index(); ++i)
+            w[N[z[u[i]]]++] = u[i];
+        for(i = 1; i <= Index(); ++i)
+            u[i] = w[i];
     }
 #endif
 
@@ -372,9 +476,13 @@ inline void BandPresentation::RightMeet(
 
 
 template<class P>
-inline Factor<P>::Factor(sint16 n, sint32 k)
-    : Pres(n)
+inline void Factor<P>::Allocate()
 {
+    if (Index() <= FactorInlineIndex) {
+        pTable = InlineTable;
+        return;
+    }
+
     pTable = new sint16[Index()];
 
 #ifdef DEBUG
@@ -383,6 +491,14 @@ inline Factor<P>::Factor(sint16 n, sint32 k)
         exit(1);
     }
 #endif
+}
+
+
+template<class P>
+inline Factor<P>::Factor(sint16 n, sint32 k)
+    : Pres(n)
+{
+    Allocate();
 
     if ((uint32)k != Uninitialize) {
         Delta(k);
@@ -394,17 +510,25 @@ template <class P>
 inline Factor<P>::Factor(const Factor& f)
     : Pres(f.Index())
 {
-    pTable = new sint16[Index()];
+    Allocate();
+    Assign(f);
+}
 
-#ifdef DEBUG
-    if (pTable == 0) {
-        std::cerr << "Factor<P>::Factor<P>(): Memory allocation error.\n";
-        exit(1);
-    }
-#endif
 
-    Assign(f);
+#if __cplusplus >= 201103L
+template <class P>
+inline Factor<P>::Factor(Factor&& f)
+    : Pres(f.Index())
+{
+    if (f.pTable == f.InlineTable) {
+        Allocate();
+        Assign(f);
+    } else {
+        pTable = f.pTable;
+        f.pTable = 0;
+    }
 }
+#endif
 
 
 template<class P>
@@ -424,7 +548,8 @@ inline Factor<P>::operator const sint16*() const
 template<class P>
 inline Factor<P>::~Factor()
 {
-    delete[] pTable;
+    if (pTable != InlineTable)
+        delete[] pTable;
 }
 
 
@@ -522,6 +647,9 @@ inline Factor<P>& Factor<P>::Assign(const Factor<P>& f)
 #endif
 
     if (&f != this) {
+        // A moved-from factor has no table.
+        if (pTable == 0)
+            Allocate();
         for(sint16 i = 1; i <= Index(); ++i) {
             At(i) = f[i];
         }
@@ -537,6 +665,20 @@ inline Factor<P>& Factor<P>::operator=(const Factor& f)
 }
 
 
+#if __cplusplus >= 201103L
+template<class P>
+inline Factor<P>& Factor<P>::operator=(Factor&& f)
+{
+    // Heap tables are swapped; inline ones have to be copied.
+    if (pTable != InlineTable && f.pTable != f.InlineTable)
+        std::swap(pTable, f.pTable);
+    else
+        Assign(f);
+    return *this;
+}
+#endif
+
+
 template<class P>
 inline bool Factor<P>::Compare(const Factor<P>& f) const
 {
@@ -718,6 +860,14 @@ inline Factor<P>& Factor<P>::Randomize()
 }
 
 
+template<class P>
+inline Factor<P>& Factor<P>::Randomize(RandomGenerator& g)
+{
+    Pres.Randomize(*this, g);
+    return *this;
+}
+
+
 template<class P>
 Factor<P> LeftMeet(const Factor<P>& a, const Factor<P>& b)
 {
@@ -804,6 +954,19 @@ inline Braid<P>::Braid(const Braid& b)
 {}
 
 
+#if __cplusplus >= 201103L
+template<class P>
+inline Braid<P>::Braid(Braid&& b)
+    : Pres(b.Pres),
+    LeftDelta(b.LeftDelta),
+    RightDelta(b.RightDelta),
+    FactorList(std::move(b.FactorList))
+{
+    b.Identity();
+}
+#endif
+
+
 template<class P>
 inline Braid<P>::Braid(const Factor<P>& f)
     : Pres(f.Index()),
@@ -862,6 +1025,22 @@ inline Braid<P>& Braid<P>::operator=(const Braid& b)
 }
 
 
+#if __cplusplus >= 201103L
+template<class P>
+inline Braid<P>& Braid<P>::operator=(Braid&& b)
+{
+    if (&b != this) {
+        Pres = b.Pres;
+        LeftDelta = b.LeftDelta;
+        RightDelta = b.RightDelta;
+        FactorList.swap(b.FactorList);
+        b.Identity();
+    }
+    return *this;
+}
+#endif
+
+
 template<class P>
 inline bool Braid<P>::Compare(const Braid& b) const
 {
@@ -1005,6 +1184,56 @@ inline Braid<P>& Braid<P>::RightMultiply(const Braid& a)
 }
 
 
+template<class P>
+Braid<P>& Braid<P>::RightMultiplyLCF(const Factor<P>& f)
+{
+
+#ifdef DEBUG
+    if (Index() != f.Index()) {
+        std::cerr << "Braid<P>::RightMultiplyLCF(): Index mismatch.\n";
+        exit(1);
+    }
+#endif
+
+    FactorList.push_back(f.Flip(-RightDelta));
+#if __cplusplus >= 201103L
+    reverse_apply_binfun(FactorList.begin(), FactorList.end(), MakeLeftWeighted<P>);
+    LeftDelta += erase_front_if(
+        FactorList, [](Factor<P>& F) { return F.CompareWithDelta(1); });
+    erase_back_if(FactorList, [](Factor<P>& F) { return F.CompareWithIdentity(); });
+#else
+    reverse_apply_binfun(FactorList.begin(), FactorList.end(),
+                         std::ptr_fun(MakeLeftWeighted<P>));
+    LeftDelta += erase_front_if(
+        FactorList, std::bind2nd(std::mem_fun_ref(&Factor<P>::CompareWithDelta), 1));
+    erase_back_if(FactorList, std::mem_fun_ref(&Factor<P>::CompareWithIdentity));
+#endif
+    return *this;
+}
+
+
+template<class P>
+Braid<P>& Braid<P>::RightMultiplyLCF(const Braid& a)
+{
+
+#ifdef DEBUG
+    if (Index() != a.Index()) {
+        std::cerr << "Braid<P>::RightMultiplyLCF(): Index mismatch.\n";
+        exit(1);
+    }
+#endif
+
+    RightDelta += a.LeftDelta;
+    for(ConstFactorItr it = a.FactorList.begin();
+        it != a.FactorList.end();
+        ++it) {
+        RightMultiplyLCF(*it);
+    }
+    RightDelta += a.RightDelta;
+    return *this;
+}
+
+
 template<class P>
 inline Braid<P>& Braid<P>::Multiply(const Braid& a, const Braid& b)
 {
@@ -1201,7 +1430,14 @@ Braid<P> Braid<P>::ReduceRightSub(const Factor<P>& SmallDelta)
 
 
 template<class P>
-Braid<P>& Braid<P>::Randomize(sint32 cl)
+inline Braid<P>& Braid<P>::Randomize(sint32 cl)
+{
+    return Randomize(cl, DefaultRandomGenerator());
+}
+
+
+template<class P>
+Braid<P>& Braid<P>::Randomize(sint32 cl, RandomGenerator& g)
 {
 
 #ifdef DEBUG
@@ -1213,7 +1449,7 @@ Braid<P>& Braid<P>::Randomize(sint32 cl)
 
     Identity();
     while (cl-- > 0) {
-        FactorList.push_back(Factor<P>(Index()).Randomize());
+        FactorList.push_back(Factor<P>(Index()).Randomize(g));
     }
     return *this;
 }   
@@ -48,6 +48,14 @@ typedef unsigned long long uint64;
 // Maximum braid index.
 const sint16 MaxBraidIndex = 300;
 
+// Maximum braid index for which the permutation table of a factor is
+// stored inside the factor rather than on the heap.
+const sint16 FactorInlineIndex = 64;
+
+// Maximum braid index for which the meet of two factors is computed
+// with bitsets, if USE_BITSET_MEET is defined at compile time.
+const sint16 BitsetMeetIndex = 64;
+
 
 // Algorithms useful in managing standard containers of Factor objects.
 
@@ -99,6 +107,36 @@ struct OddIndexError {};
 struct NegativeBraidError {};
 
 
+// Pseudo random number generator used to make random factors and
+// braids.  This is xoshiro256** of Blackman and Vigna, seeded through
+// splitmix64.  Unlike rand() of the C library it has no global state,
+// so that each thread can use its own generator, and a given seed
+// always gives the same sequence on every platform.
+class RandomGenerator {
+    uint64 State[4];
+
+public:
+    explicit RandomGenerator(uint64 seed = 0);
+    void Seed(uint64 seed);
+
+    // Return the next 64 random bits.
+    uint64 operator()();
+
+    // Return a uniformly distributed integer in [0,m[, for m > 0.
+    uint64 Uniform(uint64 m);
+
+    // Advance the generator by 2^128 steps.  Generators obtained from
+    // the same seed by successive jumps give independent sequences,
+    // for instance one per thread.
+    void Jump();
+};
+
+// The generator used by the Randomize() functions when none is given.
+// It is seeded from the time at startup, and must not be used from
+// several threads at once.
+RandomGenerator& DefaultRandomGenerator();
+
+
 // Class describing the Artin presentation and the band generator
 // presentation.  Basically they consist of the description of delta
 // and the meet operation.
@@ -135,11 +173,22 @@ public:
 
     // Generate a random factor.
     void Randomize(sint16* r) const;
+    void Randomize(sint16* r, RandomGenerator& g) const;
 
 private:
     // Subroutine called by LeftMeet() and RightMeet()
     static void MeetSub(const sint16* a, const sint16* b, sint16* r,
                         sint16 s, sint16 t);
+
+    // Left meet r of a and b for n <= BitsetMeetIndex, used instead
+    // of MeetSub() if USE_BITSET_MEET is defined.  A factor is
+    // encoded as its set of crossings, that is the pairs i<j with
+    // a[i]>a[j], stored as one 64-bit mask for each i.  The left meet
+    // is then the largest set of crossings contained in those of a
+    // and b, which is the complement of the transitive closure of the
+    // complement of their intersection.
+    static void BitsetMeetSub(const sint16* a, const sint16* b, sint16* r,
+                              sint16 n);
 };
 
 class BandPresentation {
@@ -167,9 +216,11 @@ public:
     // the above remark).
     void BStoPT(const sint8* s, sint16* a) const;
 
-    // Generate a random factor.  It works properly only if USE_CLN
-    // macro is defined at compile time.
+    // Generate a random factor.  A uniformly random ballot sequence
+    // is obtained from a random arrangement of n up-steps and n+1
+    // down-steps by the cycle lemma, so that CLN is not needed.
     void Randomize(sint16* r) const;
+    void Randomize(sint16* r, RandomGenerator& g) const;
 
     // Compute the meet r of two factors a and b.
     void LeftMeet(const sint16* a, const sint16* b, sint16* r) const;
@@ -186,8 +237,14 @@ private:
     // The presentation description.
     P Pres;
 
-    // Permutation table.
+    // Permutation table.  It points to InlineTable if the index is
+    // at most FactorInlineIndex, so that the many temporary factors
+    // created by the normal form algorithms need no heap allocation.
     sint16* pTable;
+    sint16 InlineTable[FactorInlineIndex];
+
+    // Point pTable to storage for Index() entries.
+    void Allocate();
 
 public:
 
@@ -199,6 +256,12 @@ public:
     // Copy constructor.
     Factor(const Factor& f);
 
+#if __cplusplus >= 201103L
+    // Move constructor.  A heap table is taken over from f, which
+    // may then only be assigned to or destroyed.
+    Factor(Factor&& f);
+#endif
+
     // Conversion operator to the sint16* type.  The address of the
     // permutation table is returned.  Recall that the index range is
     // [1..n], not [0,n[; when the return value is r, r[1], ... , r[n]
@@ -232,6 +295,9 @@ public:
     // Assignment operator.
     Factor& Assign(const Factor& f);
     Factor& operator=(const Factor& f);
+#if __cplusplus >= 201103L
+    Factor& operator=(Factor&& f);
+#endif
 
     // Comparison operator.
     bool Compare(const Factor& f) const;
@@ -287,6 +353,7 @@ public:
 
     // Generate a random factor.
     Factor& Randomize();
+    Factor& Randomize(RandomGenerator& g);
 };
 
 // Binary function form of the meet operators.
@@ -344,19 +411,27 @@ public:
     // Length of the canonical factor list.
     sint32 CLength;
 
-    // List of canonical factors.  According to my experiments, usual
-    // operations on a list of pointers to objects is much faster
-    // (about twice) than corresponding operations on a list of
-    // objects, especially in the case of STL lists.  Because of this,
-    // the following type declaration will be changed later.
-    std::list<Factor<P> > FactorList;
+    // Container of canonical factors.  Factors are stored
+    // contiguously in a deque, which only allocates one block for many
+    // factors, rather than one list node per factor.  Compile with
+    // CBRAID_FACTOR_LIST defined to use the old std::list instead.
+    // Iterators may be invalidated by insertions at either end, so use
+    // the FactorItr types below rather than assuming a list.
+#ifdef CBRAID_FACTOR_LIST
+    typedef std::list<Factor<P> > FactorContainer;
+#else
+    typedef std::deque<Factor<P> > FactorContainer;
+#endif
+
+    // List of canonical factors.
+    FactorContainer FactorList;
 
 public:
     // Iterator types for canonical factors.
-    typedef typename std::list<Factor<P> >::iterator FactorItr;
-    typedef typename std::list<Factor<P> >::const_iterator ConstFactorItr;
-    typedef typename std::list<Factor<P> >::reverse_iterator RevFactorItr;
-    typedef typename std::list<Factor<P> >::const_reverse_iterator ConstRevFactorItr;
+    typedef typename FactorContainer::iterator FactorItr;
+    typedef typename FactorContainer::const_iterator ConstFactorItr;
+    typedef typename FactorContainer::reverse_iterator RevFactorItr;
+    typedef typename FactorContainer::const_reverse_iterator ConstRevFactorItr;
 
 public:
     // Constructor which creates a trivial braid.
@@ -365,6 +440,12 @@ public:
     // Copy constructor.
     Braid(const Braid& b);
 
+#if __cplusplus >= 201103L
+    // Move constructor.  The factors are taken over from b, which is
+    // left trivial.
+    Braid(Braid&& b);
+#endif
+
     // Construct from a factor.
     Braid(const Factor<P>& f);
 
@@ -380,6 +461,9 @@ public:
     // Assignment operator.
     Braid& Assign(const Braid& b);
     Braid& operator=(const Braid& b);
+#if __cplusplus >= 201103L
+    Braid& operator=(Braid&& b);
+#endif
 
     // Comparison operator. Two braids are viewed as the same ones if
     // and only if they have the same internal representation. Hence
@@ -408,6 +492,16 @@ public:
     Braid& RightMultiply(const Factor<P>& f);
     Braid& LeftMultiply(const Braid& a);
     Braid& RightMultiply(const Braid& a);
+
+    // Multiplication keeping the factors left-weighted. If b is in
+    // LCF, b.RightMultiplyLCF(a) makes b into b*a, still in LCF
+    // except that the power of delta coming from a is kept in
+    // RightDelta (so MakeLCF() is needed if a has negative
+    // powers). Each factor of a is made left-weighted with the end
+    // of FactorList, going back only as long as factors change,
+    // which is usually a few of them instead of the whole braid.
+    Braid& RightMultiplyLCF(const Factor<P>& f);
+    Braid& RightMultiplyLCF(const Braid& a);
     Braid& Multiply(const Braid& a, const Braid& b);
     Braid operator*(const Braid& a) const;
     Braid& operator*=(const Braid& a);
@@ -439,6 +533,7 @@ public:
     // of cl randomly chosen canonical factors with RightDelta and
     // LeftDelta zero.
     Braid& Randomize(sint32 cl = 1);
+    Braid& Randomize(sint32 cl, RandomGenerator& g);
 
     // Friend functions.
 
@@ -463,8 +558,8 @@ ArtinBraid ToArtinBraid(const BandBraid& b);
 const cln::cl_I& GetCatalanNumber(sint16 n);
 
 // Generate the k-th ballot sequence of length 2n and store it in
-// s[1..2n] (note that s[0] is not used).  It is internally used by
-// Randomize(), but is declared as public since it has its own worth.
+// s[1..2n] (note that s[0] is not used).  It was used by Randomize()
+// before RandomGenerator, and is kept since it has its own worth.
 void BallotSequence(CBraid::sint16 n, const cln::cl_I k,
                     CBraid::sint8* s);
 
@@ -23,10 +23,12 @@
     Juan Gonzalez-Meneses <meneses(at)us.es>
 */
 
-#include "cbraid.h"
+#include "braiding.h"
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <iterator>
+#include <vector>
 
 
 namespace Braiding {
@@ -34,6 +36,7 @@ namespace Braiding {
 using CBraid::ArtinBraid;
 using CBraid::ArtinFactor;
 using CBraid::sint16;
+using CBraid::sint32;
 using std::list;
 using std::cout;
 using std::endl;
@@ -47,7 +50,7 @@ using std::endl;
 //
 ///////////////////////////////////////////////////////
 
-sint16  CL(ArtinBraid B)
+sint16  CL(const ArtinBraid& B)
 {
   sint16 n=0;
   ArtinBraid::ConstFactorItr it;
@@ -66,7 +69,7 @@ sint16  CL(ArtinBraid B)
 //
 ///////////////////////////////////////////////////////
 
-sint16  Sup(ArtinBraid B)
+sint16  Sup(const ArtinBraid& B)
 {
   sint16 s;
 
@@ -201,7 +204,7 @@ ArtinBraid WordToBraid(list<sint16> w, sint16 n)
 //
 /////////////////////////////////////////////////////////////
 
-void PrintBraidWord(ArtinBraid B)
+void PrintBraidWord(const ArtinBraid& B)
 {
   if(B.LeftDelta==1)
     {
@@ -218,7 +221,7 @@ void PrintBraidWord(ArtinBraid B)
   sint16 i, j, k, n=B.Index();
   ArtinFactor F=ArtinFactor(n);
 
-  list<ArtinFactor>::iterator it;
+  ArtinBraid::ConstFactorItr it;
 
   for(it=B.FactorList.begin(); it!=B.FactorList.end(); it++)
     {
@@ -263,7 +266,7 @@ void PrintBraidWord(ArtinBraid B)
 //
 /////////////////////////////////////////////////////////////
 
-void PrintBraidWord(ArtinBraid B, char * file)
+void PrintBraidWord(const ArtinBraid& B, char * file)
 {
   std::ofstream f(file,std::ios::app);
 
@@ -282,7 +285,7 @@ void PrintBraidWord(ArtinBraid B, char * file)
   sint16 i, j, k, n=B.Index();
   ArtinFactor F=ArtinFactor(n);
 
-  list<ArtinFactor>::iterator it;
+  ArtinBraid::ConstFactorItr it;
 
   for(it=B.FactorList.begin(); it!=B.FactorList.end(); it++)
     {
@@ -599,7 +602,7 @@ ArtinBraid SendToSSS(ArtinBraid B, ArtinBraid & C)
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor LeftWedge(ArtinFactor F1, ArtinFactor F2)
+ArtinFactor LeftWedge(const ArtinFactor& F1, const ArtinFactor& F2)
 {
   return (~RightMeet(~F1,~F2)).Flip();
 }
@@ -613,7 +616,7 @@ ArtinFactor LeftWedge(ArtinFactor F1, ArtinFactor F2)
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor RightWedge(ArtinFactor F1, ArtinFactor F2)
+ArtinFactor RightWedge(const ArtinFactor& F1, const ArtinFactor& F2)
 {
   return !LeftWedge(!F1,!F2);
 }
@@ -627,7 +630,7 @@ ArtinFactor RightWedge(ArtinFactor F1, ArtinFactor F2)
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor Remainder(ArtinBraid B, ArtinFactor F)
+ArtinFactor Remainder(const ArtinBraid& B, const ArtinFactor& F)
 {
   ArtinFactor Fi= F;
   if(B.LeftDelta!=0)
@@ -636,7 +639,7 @@ ArtinFactor Remainder(ArtinBraid B, ArtinFactor F)
       return Fi;
     }
 
-  list<ArtinFactor>::iterator it;
+  ArtinBraid::ConstFactorItr it;
   for(it=B.FactorList.begin(); it!=B.FactorList.end(); it++)
     {
 
@@ -776,7 +779,7 @@ ArtinBraid LeftWedge(ArtinBraid B1, ArtinBraid B2)
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor MinSS(ArtinBraid B, ArtinFactor F)
+ArtinFactor MinSS(const ArtinBraid& B, const ArtinFactor& F)
 {
   ArtinFactor R2=F;
   ArtinBraid W=B;
@@ -800,7 +803,7 @@ ArtinFactor MinSS(ArtinBraid B, ArtinFactor F)
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor MinSSS(ArtinBraid B, ArtinFactor F)
+ArtinFactor MinSSS(const ArtinBraid& B, const ArtinFactor& F)
 {
   ArtinFactor R=MinSS(B,F);
   sint16 cl=CL(B);
@@ -823,7 +826,7 @@ ArtinFactor MinSSS(ArtinBraid B, ArtinFactor F)
 //
 /////////////////////////////////////////////////////////////
 
-list<ArtinFactor> MinSSS(ArtinBraid B)
+list<ArtinFactor> MinSSS(const ArtinBraid& B)
 {
   sint16 i,j,k,test;
   sint16 n=B.Index();
@@ -859,13 +862,80 @@ list<ArtinFactor> MinSSS(ArtinBraid B)
 }
 
 
+/////////////////////////////////////////////////////////////
+//
+//  Hash(B)  Computes a hash value of a braid B from its powers of
+//           Delta and the permutations of its factors.
+//
+/////////////////////////////////////////////////////////////
+
+std::size_t Hash(const ArtinBraid& B)
+{
+  std::size_t h=std::size_t(B.LeftDelta)*31+std::size_t(B.RightDelta);
+  sint16 n=B.Index();
+
+  for(ArtinBraid::ConstFactorItr it=B.FactorList.begin();
+      it!=B.FactorList.end(); it++)
+    {
+      for(sint16 i=1; i<=n; i++)
+	h^=std::size_t((*it)[i])+0x9e3779b9+(h<<6)+(h>>2);
+    }
+  return h;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  SummitIndex  Hashed index of the braids in a list of orbits.
+//
+/////////////////////////////////////////////////////////////
+
+SummitIndex::SummitIndex(const list<list<ArtinBraid> > & orbits)
+{
+  sint32 k=0;
+  list<list<ArtinBraid> >::const_iterator it;
+
+  for(it=orbits.begin(); it!=orbits.end(); it++)
+    Insert(*it,++k);
+}
+
+
+void SummitIndex::Insert(const ArtinBraid & B, sint32 k)
+{
+  Braids.insert(std::make_pair(Hash(B),Entry(&B,k)));
+}
+
+
+void SummitIndex::Insert(const list<ArtinBraid> & T, sint32 k)
+{
+  list<ArtinBraid>::const_iterator it;
+
+  for(it=T.begin(); it!=T.end(); it++)
+    Insert(*it,k);
+}
+
+
+sint32 SummitIndex::Find(const ArtinBraid & B) const
+{
+  std::pair<Table::const_iterator,Table::const_iterator>
+    range=Braids.equal_range(Hash(B));
+
+  for(Table::const_iterator it=range.first; it!=range.second; it++)
+    {
+      if(*(it->second.first)==B)
+	return it->second.second;
+    }
+  return 0;
+}
+
+
 /////////////////////////////////////////////////////////////
 //
 //  SSS(B)  Given a braid B, computes its Super Summit Set.
 //
 /////////////////////////////////////////////////////////////
 
-list<ArtinBraid> SSS(ArtinBraid B)
+list<ArtinBraid> SSS(const ArtinBraid& B)
 {
   ArtinBraid B2=SendToSSS(B);
   ArtinFactor F=ArtinFactor(B.Index());
@@ -873,7 +943,9 @@ list<ArtinBraid> SSS(ArtinBraid B)
   list<ArtinFactor>::iterator itf;
 
   list<ArtinBraid> sss;
+  SummitIndex index;
   sss.push_back(B2);
+  index.Insert(sss.back(),1);
 
   list<ArtinBraid>::iterator it=sss.begin();
   while(it!=sss.end())
@@ -883,8 +955,11 @@ list<ArtinBraid> SSS(ArtinBraid B)
 	{
 	  F=*itf;
 	  B2=((!ArtinBraid(F))*(*it)*F).MakeLCF();
-	  if (find(sss.begin(),sss.end(),B2)==sss.end())
-	    sss.push_back(B2);
+	  if (index.Find(B2)==0)
+	    {
+	      sss.push_back(B2);
+	      index.Insert(sss.back(),1);
+	    }
 	}
       it++;
     }
@@ -922,7 +997,7 @@ list<ArtinBraid > Trajectory(ArtinBraid B)
 //
 /////////////////////////////////////////////////////////////
 
-ArtinBraid SendToUSS(ArtinBraid B)
+ArtinBraid SendToUSS(const ArtinBraid& B)
 {
   ArtinBraid B2=SendToSSS(B);
   list<ArtinBraid> T=Trajectory(B2);
@@ -938,7 +1013,7 @@ ArtinBraid SendToUSS(ArtinBraid B)
 //
 /////////////////////////////////////////////////////////////
 
-ArtinBraid SendToUSS(ArtinBraid B, ArtinBraid & C)
+ArtinBraid SendToUSS(const ArtinBraid& B, ArtinBraid & C)
 {
   ArtinBraid B2=SendToSSS(B,C);
   list<ArtinBraid> T=Trajectory(B2);
@@ -970,7 +1045,7 @@ ArtinBraid SendToUSS(ArtinBraid B, ArtinBraid & C)
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor Transport(ArtinBraid B, ArtinFactor F)
+ArtinFactor Transport(const ArtinBraid& B, const ArtinFactor& F)
 {
   ArtinBraid B2=((!ArtinBraid(F))*B*F).MakeLCF();
   ArtinBraid B3=((!ArtinBraid(*B.FactorList.begin()))*F*(*B2.FactorList.begin())).MakeLCF();
@@ -988,7 +1063,7 @@ ArtinFactor Transport(ArtinBraid B, ArtinFactor F)
 /////////////////////////////////////////////////////////////
 
 
-list<ArtinFactor> Returns(ArtinBraid B, ArtinFactor F)
+list<ArtinFactor> Returns(const ArtinBraid& B, const ArtinFactor& F)
 {
   list<ArtinFactor> ret;
   list<ArtinFactor>::iterator it=ret.end();
@@ -1047,7 +1122,7 @@ list<ArtinFactor> Returns(ArtinBraid B, ArtinFactor F)
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor Pullback(ArtinBraid B, ArtinFactor F)
+ArtinFactor Pullback(const ArtinBraid& B, const ArtinFactor& F)
 {
   ArtinFactor F1=(*B.FactorList.begin());
   F1=F1.Flip(B.LeftDelta+1);
@@ -1072,7 +1147,7 @@ ArtinFactor Pullback(ArtinBraid B, ArtinFactor F)
 
   ArtinFactor bi=F.Flip(B.LeftDelta);
 
-  list<ArtinFactor>::iterator it;
+  ArtinBraid::ConstFactorItr it;
   for(it=B.FactorList.begin(); it!=B.FactorList.end(); it++)
     {
       if(it!=B.FactorList.begin())
@@ -1091,7 +1166,7 @@ ArtinFactor Pullback(ArtinBraid B, ArtinFactor F)
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor MainPullback(ArtinBraid B, ArtinFactor F)
+ArtinFactor MainPullback(const ArtinBraid& B, const ArtinFactor& F)
 {
   list<ArtinFactor> ret;
   list<ArtinFactor>::iterator it=ret.end();
@@ -1156,7 +1231,7 @@ ArtinFactor MainPullback(ArtinBraid B, ArtinFactor F)
 
 
 
-ArtinFactor MinUSS(ArtinBraid B, ArtinFactor F)
+ArtinFactor MinUSS(const ArtinBraid& B, const ArtinFactor& F)
 {
   ArtinFactor F2=MinSSS(B,F);
 
@@ -1191,7 +1266,7 @@ ArtinFactor MinUSS(ArtinBraid B, ArtinFactor F)
 //
 /////////////////////////////////////////////////////////////
 
-list<ArtinFactor> MinUSS(ArtinBraid B)
+list<ArtinFactor> MinUSS(const ArtinBraid& B)
 {
   sint16 i,j,k,test;
   sint16 n=B.Index();
@@ -1239,7 +1314,7 @@ list<ArtinFactor> MinUSS(ArtinBraid B)
 //
 /////////////////////////////////////////////////////////////
 
-list<list<ArtinBraid> > USS(ArtinBraid B)
+list<list<ArtinBraid> > USS(const ArtinBraid& B)
 {
   list<list<ArtinBraid> > uss;
   ArtinFactor F=ArtinFactor(B.Index());
@@ -1250,8 +1325,14 @@ list<list<ArtinBraid> > USS(ArtinBraid B)
   ArtinBraid B2=SendToUSS(B);
   list<ArtinBraid> T=Trajectory(B2);
 
+  // Every element of the orbits found so far is indexed, so that a
+  // new orbit is recognized from its first element.
+  SummitIndex index;
+  sint32 k=0;
+
   list<ArtinBraid>::reverse_iterator rit=T.rbegin();
   uss.push_back(Trajectory(Cycling(*rit)));
+  index.Insert(uss.back(),++k);
 
   B2=((!ArtinBraid(ArtinFactor(B.Index(),1)))*(Cycling(*rit))*ArtinFactor(B.Index(),1)).MakeLCF();
   for(itb=(*uss.begin()).begin(); itb!=(*uss.begin()).end(); itb++)
@@ -1261,9 +1342,12 @@ list<list<ArtinBraid> > USS(ArtinBraid B)
     }
 
   if(itb==(*uss.begin()).end())
-    uss.push_back(Trajectory(B2));
+    {
+      uss.push_back(Trajectory(B2));
+      index.Insert(uss.back(),++k);
+    }
 
-  list<list<ArtinBraid> >::iterator it=uss.begin(), it2;
+  list<list<ArtinBraid> >::iterator it=uss.begin();
   while(it!=uss.end())
     {
 
@@ -1275,21 +1359,11 @@ list<list<ArtinBraid> > USS(ArtinBraid B)
 
 	  B2=((!ArtinBraid(F))*(*(*it).begin())*F).MakeLCF();
 
-	  T=Trajectory(B2);
-	  for(itb=T.begin(); itb!=T.end(); itb++)
-	    {
-	      for(it2=uss.begin(); it2!=uss.end(); it2++)
-		{
-		  if(*itb==*(*it2).begin())
-		    break;
-		}
-	      if(it2!=uss.end())
-		break;
-	    }
-
-	  if(itb==T.end())
+	  if(index.Find(B2)==0)
 	    {
+	      T=Trajectory(B2);
 	      uss.push_back(T);
+	      index.Insert(uss.back(),++k);
 
 	      B2=((!ArtinBraid(ArtinFactor(B.Index(),1)))*(*T.begin())*ArtinFactor(B.Index(),1)).MakeLCF();
 	      for(itb=T.begin();itb!=T.end(); itb++)
@@ -1299,7 +1373,10 @@ list<list<ArtinBraid> > USS(ArtinBraid B)
 		}
 
 	      if(itb==T.end())
-		uss.push_back(Trajectory(B2));
+		{
+		  uss.push_back(Trajectory(B2));
+		  index.Insert(uss.back(),++k);
+		}
 	    }
 	}
       it++;
@@ -1318,28 +1395,49 @@ list<list<ArtinBraid> > USS(ArtinBraid B)
 //
 /////////////////////////////////////////////////////////////
 
-list<list<ArtinBraid> > USS(ArtinBraid B, list<ArtinFactor> & mins, list<sint16> & prev)
+list<list<ArtinBraid> > USS(const ArtinBraid& B, list<ArtinFactor> & mins, list<sint32> & prev)
 {
   list<list<ArtinBraid> > uss;
+  SummitIndex index;
+
+  USS(B,uss,mins,prev,index);
+
+  return uss;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  USS(B,uss,mins,prev,index)  As USS(B,mins,prev), but the Ultra
+//                              Summit Set is stored in uss, and
+//                              indexed in 'index'.
+//
+/////////////////////////////////////////////////////////////
+
+void USS(const ArtinBraid& B, list<list<ArtinBraid> > & uss,
+	 list<ArtinFactor> & mins, list<sint32> & prev, SummitIndex & index)
+{
+  uss.clear();
+  index=SummitIndex();
 
   ArtinBraid B2=SendToUSS(B);
   list<ArtinBraid> T=Trajectory(B2);
   list<ArtinBraid>::reverse_iterator rit=T.rbegin();
   uss.push_back(Trajectory(Cycling(*rit)));
+  index.Insert(uss.back(),1);
 
   ArtinFactor F=ArtinFactor(B.Index());
   list<ArtinFactor> Min;
-  list<ArtinFactor>::iterator itf, itf2;
-  list<ArtinBraid>::iterator itb;
+  list<ArtinFactor>::iterator itf;
 
-  sint16 current=0;
+  sint32 current=0, k=1;
   mins.clear();
   prev.clear();
 
   mins.push_back(ArtinFactor(B.Index(),0));
   prev.push_back(1);
 
-  list<list<ArtinBraid> >::iterator it=uss.begin(), it2;
+  list<list<ArtinBraid> >::iterator it=uss.begin();
   while(it!=uss.end())
     {
       current++;
@@ -1350,30 +1448,49 @@ list<list<ArtinBraid> > USS(ArtinBraid B, list<ArtinFactor> & mins, list<sint16>
 	{
 	  F=*itf;
 	  B2=((!ArtinBraid(F))*(*(*it).begin())*F).MakeLCF();
-	  T=Trajectory(B2);
-	  for(itb=T.begin(); itb!=T.end(); itb++)
+	  if(index.Find(B2)==0)
 	    {
-	      for(it2=uss.begin(); it2!=uss.end(); it2++)
-		{
-		  if(*itb==*(*it2).begin())
-		    break;
-		}
-	      if(it2!=uss.end())
-		break;
-	    }
-
-	  if(itb==T.end())
-	    {
-	      uss.push_back(T);
+	      uss.push_back(Trajectory(B2));
+	      index.Insert(uss.back(),++k);
 	      mins.push_back(F);
 	      prev.push_back(current);
 	    }
 	}
       it++;
     }
+}
 
 
-  return uss;
+/////////////////////////////////////////////////////////////
+//
+//  OrbitPath(k,n,mins,prev)  Computes a braid that conjugates the
+//                            first element of the first orbit to
+//                            the first element of orbit k, from the
+//                            data stored by USS or SC in mins and prev.
+//
+/////////////////////////////////////////////////////////////
+
+static ArtinBraid OrbitPath(sint32 k, sint16 n, list<ArtinFactor> & mins, list<sint32> & prev)
+{
+  ArtinBraid C=ArtinBraid(n);
+
+  if(k==1)
+    return C;
+
+  // The lists are walked once, for random access along the path.
+  std::vector<list<ArtinFactor>::iterator> itmins;
+  std::vector<sint32> vprev(prev.begin(),prev.end());
+  itmins.reserve(mins.size());
+  for(list<ArtinFactor>::iterator itf=mins.begin(); itf!=mins.end(); itf++)
+    itmins.push_back(itf);
+
+  while(k!=1)
+    {
+      C.LeftMultiply(*itmins[k-1]);
+      k=vprev[k-1];
+    }
+
+  return C;
 }
 
 
@@ -1385,53 +1502,42 @@ list<list<ArtinBraid> > USS(ArtinBraid B, list<ArtinFactor> & mins, list<sint16>
 //
 /////////////////////////////////////////////////////////////
 
-ArtinBraid   TreePath(ArtinBraid B, list<list<ArtinBraid> > & uss, list<ArtinFactor> & mins, list<sint16> & prev)
+ArtinBraid   TreePath(const ArtinBraid& B, list<list<ArtinBraid> > & uss, list<ArtinFactor> & mins, list<sint32> & prev)
+{
+  return TreePath(B,uss,mins,prev,SummitIndex(uss));
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  TreePath(B,uss,mins,prev,index)  As TreePath(B,uss,mins,prev),
+//                                   using the index of the uss.
+//
+/////////////////////////////////////////////////////////////
+
+ArtinBraid   TreePath(const ArtinBraid& B, list<list<ArtinBraid> > & uss, list<ArtinFactor> & mins, list<sint32> & prev, const SummitIndex & index)
 {
   sint16 n=B.Index();
-  ArtinBraid C=ArtinBraid(n);
-  list<list<ArtinBraid> >::iterator it;
-  list<ArtinBraid>::iterator itb, itb2;
-  sint16 current=0;
-  list<sint16>::iterator itprev;
-  list<ArtinFactor>::iterator itmins;
-  sint16 i;
 
   if(CL(B)==0)
     return ArtinBraid(n);
 
-  for(it=uss.begin(); it!=uss.end(); it++)
-    {
-      current++;
-      for(itb=(*it).begin(); itb!=(*it).end(); itb++)
-	{
-	  if(*itb==B)
-	    break;
-	}
-      if(itb!=(*it).end())
-	break;
-    }
+  sint32 current=index.Find(B);
 
-  if(it==uss.end())
+  if(current==0)
     {
       cout << "Error in TreePath" << endl;
       return 0;
     }
 
-  for(itb2=(*it).begin(); itb2!=itb; itb2++)
-    C.RightMultiply((*(*itb2).FactorList.begin()).Flip(B.LeftDelta));
+  list<list<ArtinBraid> >::iterator it=uss.begin();
+  std::advance(it,current-1);
 
-  while(current!=1)
-    {
-      itprev=prev.begin();
-      itmins=mins.begin();
-      for(i=1; i<current; i++)
-	{
-	  itprev++;
-	  itmins++;
-	}
-      C.LeftMultiply(*itmins);
-      current=*itprev;
-    }
+  ArtinBraid C=OrbitPath(current,n,mins,prev);
+  list<ArtinBraid>::iterator itb;
+
+  for(itb=(*it).begin(); *itb!=B; itb++)
+    C.RightMultiply((*(*itb).FactorList.begin()).Flip(B.LeftDelta));
 
   return C;
 }
@@ -1445,7 +1551,7 @@ ArtinBraid   TreePath(ArtinBraid B, list<list<ArtinBraid> > & uss, list<ArtinFac
 //
 /////////////////////////////////////////////////////////////
 
-bool AreConjugate(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C)
+bool AreConjugate(const ArtinBraid& B1, const ArtinBraid& B2, ArtinBraid & C)
 {
   sint16 n=B1.Index();
   ArtinBraid C1=ArtinBraid(n), C2=ArtinBraid(n);
@@ -1463,49 +1569,25 @@ bool AreConjugate(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C)
     }
 
   list<ArtinFactor> mins;
-  list<sint16> prev;
-
-  list<list<ArtinBraid> > uss=USS(BT1,mins,prev);
+  list<sint32> prev;
+  list<list<ArtinBraid> > uss;
+  SummitIndex index;
 
-  list<list<ArtinBraid> >::iterator   it;
-  list<ArtinBraid>::iterator    itb;
-  sint16  current=0;
-  ArtinBraid D1=ArtinBraid(n), D2=ArtinBraid(n);
+  USS(BT1,uss,mins,prev,index);
 
+  sint32 current=index.Find(BT2);
 
-  for(it=uss.begin(); it!=uss.end(); it++)
-    {
-      current++;
-      D2=ArtinBraid(n);
-      for(itb=(*it).begin(); itb!=(*it).end(); itb++)
-	{
-	  if(*itb==BT2)
-	    break;
-	  D2=D2*((*(*itb).FactorList.begin()).Flip((*itb).LeftDelta));
-	}
-      if(itb!=(*it).end())
-	break;
-    }
-
-  if(it==uss.end())
+  if(current==0)
     return false;
 
-  list<sint16>::iterator itprev;
-  list<ArtinFactor>::iterator itmins;
-  sint16 i;
+  list<list<ArtinBraid> >::iterator it=uss.begin();
+  std::advance(it,current-1);
 
-  while(current!=1)
-    {
-      itprev=prev.begin();
-      itmins=mins.begin();
-      for(i=1; i<current; i++)
-	{
-	  itprev++;
-	  itmins++;
-	}
-      D1.LeftMultiply(*itmins);
-      current=*itprev;
-    }
+  list<ArtinBraid>::iterator itb;
+  ArtinBraid D1=OrbitPath(current,n,mins,prev), D2=ArtinBraid(n);
+
+  for(itb=(*it).begin(); *itb!=BT2; itb++)
+    D2=D2*((*(*itb).FactorList.begin()).Flip((*itb).LeftDelta));
 
   C=(C1*D1*D2*(!C2)).MakeLCF();
 
@@ -1522,7 +1604,7 @@ bool AreConjugate(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C)
 /////////////////////////////////////////////////////////////
 
 
-list<ArtinBraid> Centralizer(list<list<ArtinBraid> > & uss, list<ArtinFactor> & mins, list<sint16> & prev)
+list<ArtinBraid> Centralizer(list<list<ArtinBraid> > & uss, list<ArtinFactor> & mins, list<sint32> & prev)
 {
   ArtinBraid B=*(*uss.begin()).begin();
   sint16  n=B.Index();
@@ -1534,8 +1616,6 @@ list<ArtinBraid> Centralizer(list<list<ArtinBraid> > & uss, list<ArtinFactor> &
   list<sint16> word;
   list<ArtinFactor> Min;
   list<ArtinFactor>::iterator itMin;
-  list<sint16>::iterator itprev;
-  list<ArtinFactor>::iterator itmins;
 
   if(cl==0 && sup%2==0)
     {
@@ -1561,9 +1641,11 @@ list<ArtinBraid> Centralizer(list<list<ArtinBraid> > & uss, list<ArtinFactor> &
       return Cent;
     }
 
+  SummitIndex index(uss);
+
   for(it=uss.begin(); it!=uss.end(); it++)
     {
-      D=TreePath(*(*it).begin(),uss,mins,prev);
+      D=TreePath(*(*it).begin(),uss,mins,prev,index);
       C=D;
       for(itb=(*it).begin(); itb!=(*it).end(); itb++)
 	C=C*((*(*itb).FactorList.begin()).Flip(B.LeftDelta));
@@ -1578,7 +1660,7 @@ list<ArtinBraid> Centralizer(list<list<ArtinBraid> > & uss, list<ArtinFactor> &
 	{
 	  C=D*(*itMin);
 	  B2=((!ArtinBraid(*itMin))*(*(*it).begin())*(*itMin)).MakeLCF();
-	  E=TreePath(B2,uss,mins,prev);
+	  E=TreePath(B2,uss,mins,prev,index);
 	  C=C*(!E);
 	  C.MakeLCF();
 
@@ -1598,11 +1680,11 @@ list<ArtinBraid> Centralizer(list<list<ArtinBraid> > & uss, list<ArtinFactor> &
 //
 /////////////////////////////////////////////////////////////
 
-list<ArtinBraid> Centralizer(ArtinBraid B)
+list<ArtinBraid> Centralizer(const ArtinBraid& B)
 {
   sint16 n=B.Index();
   list<ArtinFactor> mins;
-  list<sint16> prev;
+  list<sint32> prev;
   list<list<ArtinBraid> > uss=USS(B,mins,prev);
 
   list<ArtinBraid> Cent=Centralizer(uss,mins,prev);
@@ -1630,7 +1712,7 @@ list<ArtinBraid> Centralizer(ArtinBraid B)
 //
 /////////////////////////////////////////////////////////////
 
-void Tableau(ArtinFactor F, sint16 **& tab)
+void Tableau(const ArtinFactor& F, sint16 **& tab)
 {
   sint16 i,j;
   sint16 n=F.Index();
@@ -1687,7 +1769,7 @@ bool Circles(ArtinBraid B)
   delta=delta%2;
 
   sint16 *** tabarray=new sint16**[cl+delta];
-  list<ArtinFactor>::iterator it=B.FactorList.begin();
+  ArtinBraid::FactorItr it=B.FactorList.begin();
 
   for (j=0; j<cl+delta; j++)
     {
@@ -1887,7 +1969,7 @@ sint16 Rigidity(ArtinBraid B)
   B3=B3*F;
   B3.MakeLCF();
 
-  list<ArtinFactor>::iterator it2, it3;
+  ArtinBraid::FactorItr it2, it3;
 
   it3=B3.FactorList.begin();
 
@@ -2311,7 +2393,7 @@ char * FileName(sint16 iteration, sint16 max_iteration, sint16 type, sint16 orbi
 /////////////////////////////////////////////////////////////
 
 
-ArtinBraid RightMeet(ArtinBraid B1, ArtinBraid B2)
+ArtinBraid RightMeet(const ArtinBraid& B1, const ArtinBraid& B2)
 {
   return Reverse(LeftMeet(Reverse(B1),Reverse(B2)));
 }
@@ -2392,7 +2474,7 @@ ArtinBraid LeftJoin(ArtinBraid B1, ArtinBraid B2)
 //
 /////////////////////////////////////////////////////////////
 
-ArtinBraid RightJoin(ArtinBraid B1, ArtinBraid B2)
+ArtinBraid RightJoin(const ArtinBraid& B1, const ArtinBraid& B2)
 {
   return Reverse(LeftJoin(Reverse(B1),Reverse(B2)));
 }
@@ -2404,7 +2486,7 @@ ArtinBraid RightJoin(ArtinBraid B1, ArtinBraid B2)
 //
 ///////////////////////////////////////////////////////
 
-ArtinFactor  InitialFactor(ArtinBraid B)
+ArtinFactor  InitialFactor(const ArtinBraid& B)
 {
  sint16 n=B.Index();
  ArtinFactor F=ArtinFactor(n,0);
@@ -2423,7 +2505,7 @@ ArtinFactor  InitialFactor(ArtinBraid B)
 //
 ///////////////////////////////////////////////////////
 
-ArtinFactor  PreferredPrefix(ArtinBraid B)
+ArtinFactor  PreferredPrefix(const ArtinBraid& B)
 {
 ArtinFactor F=ArtinFactor(B.Index(),0);
 
@@ -2466,7 +2548,7 @@ return F;
 //
 ///////////////////////////////////////////////////////
 
-ArtinFactor  PreferredSuffix(ArtinBraid B)
+ArtinFactor  PreferredSuffix(const ArtinBraid& B)
 {
  return  !(PreferredPrefix(Reverse(B)));
 }
@@ -2564,7 +2646,7 @@ list<ArtinBraid > Trajectory_Sliding(ArtinBraid B, ArtinBraid & C, sint16 & d)
 /////////////////////////////////////////////////////////////
 
 
-ArtinBraid SendToSC(ArtinBraid B)
+ArtinBraid SendToSC(const ArtinBraid& B)
 {
   list<ArtinBraid> T=Trajectory_Sliding(B);
   return Sliding(T.back()); 
@@ -2588,7 +2670,7 @@ ArtinBraid SendToSC(ArtinBraid B)
 /////////////////////////////////////////////////////////////
 
 
-ArtinBraid SendToSC(ArtinBraid B, ArtinBraid & C)
+ArtinBraid SendToSC(const ArtinBraid& B, ArtinBraid & C)
 {
   sint16 d;
   list<ArtinBraid> T=Trajectory_Sliding(B,C,d);
@@ -2611,7 +2693,7 @@ ArtinBraid SendToSC(ArtinBraid B, ArtinBraid & C)
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor Transport_Sliding(ArtinBraid B, ArtinFactor F)
+ArtinFactor Transport_Sliding(const ArtinBraid& B, const ArtinFactor& F)
 {
 ArtinBraid B2=((!ArtinBraid(F))*B*F).MakeLCF();
 ArtinBraid B3=((!ArtinBraid(PreferredPrefix(B)))*F*(PreferredPrefix(B2))).MakeLCF(); 
@@ -2643,7 +2725,7 @@ return F2;
 /////////////////////////////////////////////////////////////
 
 
-list<ArtinFactor> Returns_Sliding(ArtinBraid B, ArtinFactor F) 
+list<ArtinFactor> Returns_Sliding(const ArtinBraid& B, ArtinFactor F) 
 {
  list<ArtinFactor> ret;
  list<ArtinFactor>::iterator it=ret.end();
@@ -2694,7 +2776,7 @@ return ret;
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor Pullback_Sliding(ArtinBraid B, ArtinFactor F)
+ArtinFactor Pullback_Sliding(const ArtinBraid& B, const ArtinFactor& F)
 {
 
  ArtinBraid B2=ArtinBraid(B.Index());
@@ -2737,7 +2819,7 @@ ArtinFactor Pullback_Sliding(ArtinBraid B, ArtinFactor F)
 //
 /////////////////////////////////////////////////////////////
 
-ArtinFactor MainPullback_Sliding(ArtinBraid B, ArtinFactor F)
+ArtinFactor MainPullback_Sliding(const ArtinBraid& B, const ArtinFactor& F)
 {
 
 
@@ -2781,7 +2863,7 @@ return *it;
 
 
 
-ArtinFactor MinSC(ArtinBraid B, ArtinFactor F) 
+ArtinFactor MinSC(const ArtinBraid& B, const ArtinFactor& F) 
 {
   ArtinFactor F2=MinSSS(B,F);
 
@@ -2817,7 +2899,7 @@ return ArtinFactor(B.Index(),1);
 //
 /////////////////////////////////////////////////////////////
 
-list<ArtinFactor> MinSC(ArtinBraid B)
+list<ArtinFactor> MinSC(const ArtinBraid& B)
 {
   sint16 i,j,k,test;
   sint16 n=B.Index();
@@ -2867,7 +2949,7 @@ list<ArtinFactor> MinSC(ArtinBraid B)
 /////////////////////////////////////////////////////////////
 
 
-list<list<ArtinBraid> > SC(ArtinBraid B)
+list<list<ArtinBraid> > SC(const ArtinBraid& B)
 {
   list<list<ArtinBraid> > sc;
   ArtinFactor F=ArtinFactor(B.Index());
@@ -2876,9 +2958,15 @@ list<list<ArtinBraid> > SC(ArtinBraid B)
   list<ArtinBraid>::iterator itb;
 
   ArtinBraid B2=SendToSC(B);
-  list<ArtinBraid> T=Trajectory_Sliding(B2);  
-  
+  list<ArtinBraid> T;
+
+  // Every element of the orbits found so far is indexed, so that a
+  // new orbit is recognized from its first element.
+  SummitIndex index;
+  sint32 k=0;
+
   sc.push_back(Trajectory_Sliding(B2));
+  index.Insert(sc.back(),++k);
 
   B2=((!ArtinBraid(ArtinFactor(B.Index(),1)))*(B2)*ArtinFactor(B.Index(),1)).MakeLCF();
  
@@ -2890,10 +2978,13 @@ list<list<ArtinBraid> > SC(ArtinBraid B)
 
 
   if(itb==(*sc.begin()).end())
-    sc.push_back(Trajectory_Sliding(B2));
+    {
+      sc.push_back(Trajectory_Sliding(B2));
+      index.Insert(sc.back(),++k);
+    }
 
  
-  list<list<ArtinBraid> >::iterator it=sc.begin(), it2;
+  list<list<ArtinBraid> >::iterator it=sc.begin();
 
   while(it!=sc.end())
     {
@@ -2904,21 +2995,11 @@ list<list<ArtinBraid> > SC(ArtinBraid B)
 	{
 	  F=*itf;	  	  
       B2=((!ArtinBraid(F))*(*(*it).begin())*F).MakeLCF();     	  
-	  T=Trajectory_Sliding(B2);
- 	  for(itb=T.begin(); itb!=T.end(); itb++)
-	    {
-	      for(it2=sc.begin(); it2!=sc.end(); it2++)
-		{
-		  if(*itb==*(*it2).begin())
-		    break;
-		}
-	      if(it2!=sc.end())
-		break;
-	    }
- 
-	  if(itb==T.end())
+	  if(index.Find(B2)==0)
 	    {
+	      T=Trajectory_Sliding(B2);
 	      sc.push_back(T);
+	      index.Insert(sc.back(),++k);
 	      B2=((!ArtinBraid(ArtinFactor(B.Index(),1)))*(*T.begin())*ArtinFactor(B.Index(),1)).MakeLCF(); 
 	      for(itb=T.begin();itb!=T.end(); itb++)
 		{
@@ -2926,7 +3007,10 @@ list<list<ArtinBraid> > SC(ArtinBraid B)
 		    break;
 		}
 	      if(itb==T.end())
-		sc.push_back(Trajectory_Sliding(B2));
+		{
+		  sc.push_back(Trajectory_Sliding(B2));
+		  index.Insert(sc.back(),++k);
+		}
 	    }
 	}
       it++;
@@ -3072,27 +3156,47 @@ void PrintSC(list<list<ArtinBraid> > &  sc, list<sint16> word, sint16 n,
 //
 /////////////////////////////////////////////////////////////
 
-list<list<ArtinBraid> > SC(ArtinBraid B, list<ArtinFactor> & mins, list<sint16> & prev)
+list<list<ArtinBraid> > SC(const ArtinBraid& B, list<ArtinFactor> & mins, list<sint32> & prev)
 {
   list<list<ArtinBraid> > sc;
+  SummitIndex index;
+
+  SC(B,sc,mins,prev,index);
+
+  return sc;
+}
+
+
+/////////////////////////////////////////////////////////////
+//
+//  SC(B,sc,mins,prev,index)  As SC(B,mins,prev), but the Set of
+//                            Sliding Circuits is stored in sc, and
+//                            indexed in 'index'.
+//
+/////////////////////////////////////////////////////////////
+
+void SC(const ArtinBraid& B, list<list<ArtinBraid> > & sc,
+	list<ArtinFactor> & mins, list<sint32> & prev, SummitIndex & index)
+{
+  sc.clear();
+  index=SummitIndex();
 
   ArtinBraid B2=SendToSC(B);
-  list<ArtinBraid> T=Trajectory_Sliding(B2);
   sc.push_back(Trajectory_Sliding(B2));
+  index.Insert(sc.back(),1);
 
   ArtinFactor F=ArtinFactor(B.Index());
   list<ArtinFactor> Min;
-  list<ArtinFactor>::iterator itf, itf2;
-  list<ArtinBraid>::iterator itb;
+  list<ArtinFactor>::iterator itf;
 
-  sint16 current=0;
+  sint32 current=0, k=1;
   mins.clear();
   prev.clear();
 
   mins.push_back(ArtinFactor(B.Index(),0));
   prev.push_back(1);
 
-  list<list<ArtinBraid> >::iterator it=sc.begin(), it2;
+  list<list<ArtinBraid> >::iterator it=sc.begin();
   while(it!=sc.end())
     {
       current++;
@@ -3103,30 +3207,16 @@ list<list<ArtinBraid> > SC(ArtinBraid B, list<ArtinFactor> & mins, list<sint16>
 	{
 	  F=*itf;
 	  B2=((!ArtinBraid(F))*(*(*it).begin())*F).MakeLCF();
-      T=Trajectory_Sliding(B2);
-	  for(itb=T.begin(); itb!=T.end(); itb++)
+	  if(index.Find(B2)==0)
 	    {
-	      for(it2=sc.begin(); it2!=sc.end(); it2++)
-		{
-		  if(*itb==*(*it2).begin())
-		    break;
-		}
-	      if(it2!=sc.end())
-		break;
-	    }
-
-	  if(itb==T.end())
-	    {
-	      sc.push_back(T);
+	      sc.push_back(Trajectory_Sliding(B2));
+	      index.Insert(sc.back(),++k);
 	      mins.push_back(F);
 	      prev.push_back(current);
 	    }
 	}
       it++;
     }
-
-
-  return sc;
 }
 
 
@@ -3138,7 +3228,7 @@ list<list<ArtinBraid> > SC(ArtinBraid B, list<ArtinFactor> & mins, list<sint16>
 //
 //////////////////////////////////////////////////////////////////////////////////
 
-bool AreConjugateSC(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C)
+bool AreConjugateSC(const ArtinBraid& B1, const ArtinBraid& B2, ArtinBraid & C)
 {
   sint16 n=B1.Index();
   ArtinBraid C1=ArtinBraid(n), C2=ArtinBraid(n);
@@ -3155,49 +3245,25 @@ bool AreConjugateSC(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C)
     }
 
   list<ArtinFactor> mins;
-  list<sint16> prev;
-
-  list<list<ArtinBraid> > sc=SC(BT1,mins,prev);
+  list<sint32> prev;
+  list<list<ArtinBraid> > sc;
+  SummitIndex index;
 
-  list<list<ArtinBraid> >::iterator   it;
-  list<ArtinBraid>::iterator    itb;
-  sint16  current=0;
-  ArtinBraid D1=ArtinBraid(n), D2=ArtinBraid(n);
+  SC(BT1,sc,mins,prev,index);
 
+  sint32 current=index.Find(BT2);
 
-  for(it=sc.begin(); it!=sc.end(); it++)
-    {
-      current++;
-      D2=ArtinBraid(n);
-      for(itb=(*it).begin(); itb!=(*it).end(); itb++)
-	{
-	  if(*itb==BT2)
-	    break;
-	  D2=D2*PreferredPrefix(*itb);
-	}
-      if(itb!=(*it).end())
-	break;
-    }
-
-  if(it==sc.end())
+  if(current==0)
     return false;
 
-  list<sint16>::iterator itprev;
-  list<ArtinFactor>::iterator itmins;
-  sint16 i;
+  list<list<ArtinBraid> >::iterator it=sc.begin();
+  std::advance(it,current-1);
 
-  while(current!=1)
-    {
-      itprev=prev.begin();
-      itmins=mins.begin();
-      for(i=1; i<current; i++)
-	{
-	  itprev++;
-	  itmins++;
-	}
-      D1.LeftMultiply(*itmins);
-      current=*itprev;
-    }
+  list<ArtinBraid>::iterator itb;
+  ArtinBraid D1=OrbitPath(current,n,mins,prev), D2=ArtinBraid(n);
+
+  for(itb=(*it).begin(); *itb!=BT2; itb++)
+    D2=D2*PreferredPrefix(*itb);
 
   C=(C1*D1*D2*(!C2)).MakeLCF();
 
@@ -3216,7 +3282,7 @@ bool AreConjugateSC(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C)
 //////////////////////////////////////////////////////////////////////////////////
 
 
-bool AreConjugateSC2(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C)
+bool AreConjugateSC2(const ArtinBraid& B1, const ArtinBraid& B2, ArtinBraid & C)
 {
   list<list<ArtinBraid> > sc; 
   sint16 n=B1.Index();
@@ -3231,47 +3297,30 @@ bool AreConjugateSC2(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C)
   ArtinBraid D1=ArtinBraid(n), D2=ArtinBraid(n); 
 
   list<ArtinFactor> mins;
-  list<sint16> prev;
+  list<sint32> prev;
+  SummitIndex index;
   
-  sint16 current=0;
-  sint16 current2=0; 
+  sint32 current=0, k=1;
   mins.clear();
   prev.clear();
 
-  list<sint16>::iterator itprev;
-  list<ArtinFactor>::iterator itmins;
-  sint16 i;  
-  
   mins.push_back(ArtinFactor(B1.Index(),0));
   prev.push_back(1);
 
-  list<ArtinBraid> T=Trajectory_Sliding(BT1);
-  
   sc.push_back(Trajectory_Sliding(BT1));  
+  index.Insert(sc.back(),1);
  
-  list<list<ArtinBraid> >::iterator it=sc.begin(), it2;
+  list<list<ArtinBraid> >::iterator it=sc.begin();
 
   while(it!=sc.end()) 
     {    
       current++;               
-       current2++;
        D2=ArtinBraid(n);
        for(itb=(*it).begin(); itb!=(*it).end(); itb++)
 	    {
 	      if(*itb==BT2) 
           {
-           while(current2!=1)
-           {
-            itprev=prev.begin();
-            itmins=mins.begin();
-            for(i=1; i<current2; i++)
-             {
-             itprev++;
-             itmins++;
-             }
-            D1.LeftMultiply(*itmins);
-            current2=*itprev;
-           }
+          D1=OrbitPath(current,n,mins,prev);
           C=(C1*D1*D2*(!C2)).MakeLCF();
           return true;  
           }
@@ -3286,21 +3335,10 @@ bool AreConjugateSC2(ArtinBraid B1, ArtinBraid B2, ArtinBraid & C)
 	  F=*itf;   	  
       BT1=((!ArtinBraid(F))*(*(*it).begin())*F).MakeLCF(); 
           	  
-	  T=Trajectory_Sliding(BT1); 
- 	  for(itb=T.begin(); itb!=T.end(); itb++) 
+	  if(index.Find(BT1)==0)
 	    {
-	      for(it2=sc.begin(); it2!=sc.end(); it2++) 
-		{
-		  if(*itb==*(*it2).begin()) 
-		    break;
-		}
-	      if(it2!=sc.end()) 
-		break;
-	    }
-        
-	  if(itb==T.end())
-	    {
-	      sc.push_back(T);
+	      sc.push_back(Trajectory_Sliding(BT1));
+	      index.Insert(sc.back(),++k);
 	      mins.push_back(F);
 	      prev.push_back(current);
 	    }
@@ -32,30 +32,28 @@
 
 namespace CBraid {
 
-// A class used to feed a seed to the random number generator of C
-// library.
-
-class _RandomSeedInitializer {
-public:
-    _RandomSeedInitializer() {
-        std::srand(std::time(NULL));
-    }
-};
-
-static _RandomSeedInitializer RandomSeedInitializer;
+// The generator is created on first use, so that it is seeded even
+// if Randomize() is called during static initialization.
+RandomGenerator& DefaultRandomGenerator()
+{
+    static RandomGenerator g(std::time(NULL));
+    return g;
+}
 
 
 void ArtinPresentation::MeetSub(const sint16* a, const sint16* b, sint16* r,
                                 sint16 s, sint16 t)
 {
-    static sint16 u[MaxBraidIndex], v[MaxBraidIndex], w[MaxBraidIndex];
-
     if (s >= t)
         return;
     sint16 m = (s+t)/2;
     MeetSub(a, b, r, s, m);
     MeetSub(a, b, r, m+1, t);
 
+    // Scratch space is on the stack, so that this is reentrant.  The
+    // depth of recursion is only log2(t-s).
+    sint16 u[MaxBraidIndex], v[MaxBraidIndex], w[MaxBraidIndex];
+
     u[m] = a[r[m]];
     v[m] = b[r[m]];
     if (s < m) {
@@ -83,6 +81,89 @@ void ArtinPresentation::MeetSub(const sint16* a, const sint16* b, sint16* r,
 }
 
 
+// Bit operations on the 64-bit masks used by BitsetMeetSub().
+
+static inline sint16 PopCount(uint64 x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(x);
+#else
+    x = x - ((x >> 1) & 0x5555555555555555ULL);
+    x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+    x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fULL;
+    return sint16((x * 0x0101010101010101ULL) >> 56);
+#endif
+}
+
+// Index of the lowest set bit of x, which must be nonzero.
+static inline sint16 LowestBit(uint64 x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#else
+    return PopCount((x & (~x+1)) - 1);
+#endif
+}
+
+// Mask of the bits above bit k.
+static inline uint64 BitsAbove(sint16 k)
+{
+    return (k >= 63) ? 0 : (~0ULL << (k+1));
+}
+
+
+void ArtinPresentation::BitsetMeetSub(const sint16* a, const sint16* b,
+                                      sint16* r, sint16 n)
+{
+    // Bit j of x[i] is set if (i+1,j+1) is a crossing of a and of b.
+    // Positions are taken in the order of increasing a[i] (resp. b[i]),
+    // so that the crossings of i are the positions seen before it.
+    uint64 x[BitsetMeetIndex], y[BitsetMeetIndex];
+    sint16 u[BitsetMeetIndex+1], v[BitsetMeetIndex+1];
+    for(sint16 i = 1; i <= n; ++i) {
+        u[a[i]] = i-1;
+        v[b[i]] = i-1;
+    }
+    uint64 su = 0, sv = 0;
+    for(sint16 k = 1; k <= n; ++k) {
+        x[u[k]] = su & BitsAbove(u[k]);
+        su |= 1ULL << u[k];
+        y[v[k]] = sv & BitsAbove(v[k]);
+        sv |= 1ULL << v[k];
+    }
+    const uint64 all = su;
+
+    // Transitive closure of the pairs that are not common crossings.
+    // Rows below i are already closed, so it is enough to add the rows
+    // of the pairs not yet reached from i.
+    for(sint16 i = n-1; i >= 0; --i) {
+        uint64 c = all & BitsAbove(i) & ~(x[i] & y[i]);
+        uint64 m = c;
+        while (m) {
+            sint16 j = LowestBit(m);
+            c |= x[j];
+            m &= ~(x[j] | (1ULL << j));
+        }
+        x[i] = c;
+    }
+
+    // The crossings of r are the pairs that are not in the closure.
+    // The number of crossings (i,j) is the number of entries after
+    // r[i] that are smaller than it, so r[i] is the corresponding
+    // unused entry.
+    uint64 unused = all;
+    for(sint16 i = 0; i < n; ++i) {
+        sint16 c = PopCount(all & BitsAbove(i) & ~x[i]);
+        uint64 m = unused;
+        while (c--)
+            m &= m-1;
+        sint16 k = LowestBit(m);
+        unused &= ~(1ULL << k);
+        r[i+1] = k+1;
+    }
+}
+
+
 BandBraid ToBandBraid(const ArtinBraid& a)
 {
     sint32 n = a.Index();
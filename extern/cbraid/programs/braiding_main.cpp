@@ -178,7 +178,7 @@ int main()
 
 	      ArtinFactor F=ArtinFactor(n, B.LeftDelta);
 
-	      list<ArtinFactor>::iterator itf = B.FactorList.begin();
+	      ArtinBraid::FactorItr itf = B.FactorList.begin();
 	      while (itf != B.FactorList.end())
 		F *= *(itf++);
 
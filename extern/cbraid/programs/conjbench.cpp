@@ -0,0 +1,169 @@
+/*
+    Copyright (C) 2000-2001 Jae Choon Cha.
+
+    This file is part of CBraid.
+
+    CBraid is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    CBraid is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CBraid; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+
+/*
+    Benchmark for the conjugacy test of Braiding, as used by
+    braidlab's conjtest.
+
+    Random braids x are compared with random conjugates y*x*!y using
+    Braiding::AreConjugate.  Besides the time, the number of heap
+    allocations is reported: most of them come from copies of braids
+    passed between the algorithms, so this measures how many copies
+    are made.
+*/
+
+
+#include "cbraid.h"
+#include "braiding.h"
+
+#include "optarg.h"
+#include "timecounter.h"
+
+#include <iostream>
+#include <cstdlib>
+#include <new>
+
+
+// Global option variables.
+int Index = 5;
+int CLength = 4;
+int Count = 20;
+int CLibRandomSeed = 0;
+
+
+// Count heap allocations by replacing the global operator new.  All
+// the forms of new and delete are replaced, so that they all go through
+// malloc and free.
+static unsigned long Allocations = 0;
+
+#if __cplusplus >= 201103L
+#define CONJBENCH_NOTHROW noexcept
+#else
+#define CONJBENCH_NOTHROW throw()
+#endif
+
+// GCC warns about mismatched allocation functions when it inlines only
+// one of operator new and operator delete (malloc or free against the
+// other operator), so they are all kept out of line.
+#if defined(__GNUC__)
+#define CONJBENCH_NOINLINE __attribute__((noinline))
+#else
+#define CONJBENCH_NOINLINE
+#endif
+
+CONJBENCH_NOINLINE void* operator new(std::size_t size)
+{
+    ++Allocations;
+    void* p = std::malloc(size ? size : 1);
+    if (p == 0)
+        throw std::bad_alloc();
+    return p;
+}
+
+CONJBENCH_NOINLINE void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+CONJBENCH_NOINLINE void operator delete(void* p) CONJBENCH_NOTHROW
+{
+    std::free(p);
+}
+
+CONJBENCH_NOINLINE void operator delete[](void* p) CONJBENCH_NOTHROW
+{
+    std::free(p);
+}
+
+#if __cpp_sized_deallocation
+CONJBENCH_NOINLINE void operator delete(void* p, std::size_t)
+    CONJBENCH_NOTHROW
+{
+    std::free(p);
+}
+
+CONJBENCH_NOINLINE void operator delete[](void* p, std::size_t)
+    CONJBENCH_NOTHROW
+{
+    std::free(p);
+}
+#endif
+
+
+int main(int argc, char* argv[])
+{
+    using namespace CBraid;
+    using namespace std;
+
+    // Process command line options.
+    OptArg::optmap m;
+    m << OptArg::opt("-index", OptArg::int_arg, &Index)
+      << OptArg::opt("-clength", OptArg::int_arg, &CLength)
+      << OptArg::opt("-count", OptArg::int_arg, &Count)
+      << OptArg::opt("-srand", OptArg::int_arg, &CLibRandomSeed);
+    try {
+        OptArg::process_option(argv+1, argv+argc, m);
+    }
+    catch (OptArg::bad_optarg_seq e) {
+        cerr << "Bad argument: " << e.option_name << endl;
+        exit(1);
+    }
+
+    if (CLibRandomSeed)
+        DefaultRandomGenerator().Seed(CLibRandomSeed);
+
+    cout << "Conjugacy test, with parameters n=" << Index
+         << ", l=" << CLength << ", count=" << Count << endl;
+
+    TimeCounter t;
+    clock_t ticks = 0;
+    unsigned long allocs = 0;
+    int conj = 0;
+
+    for(int i = 0; i < Count; ++i) {
+        ArtinBraid x(Index), y(Index), C(Index);
+        x.Randomize(CLength);
+        y.Randomize(CLength);
+        ArtinBraid z = y*x*!y;
+        x.MakeLCF();
+        z.MakeLCF();
+
+        unsigned long a0 = Allocations;
+        t.Start();
+        conj += Braiding::AreConjugate(x, z, C);
+        t.Stop();
+        allocs += Allocations - a0;
+        ticks += t.IntervalClock();
+
+        // Check the conjugating braid.
+        if (!(((!C)*x*C).MakeLCF() == z)) {
+            cerr << "Wrong conjugating braid.\n";
+            exit(1);
+        }
+        flush(cout << ".");
+    }
+
+    cout << "\nConjugate pairs found: " << conj << "/" << Count
+         << "\nExecution time=" << double(ticks)/TimeCounter::ClocksPerSec
+         << " sec, allocations per test=" << allocs/Count << endl;
+
+    return (conj == Count) ? 0 : 1;
+}
@@ -0,0 +1,148 @@
+/*
+    Copyright (C) 2000-2001 Jae Choon Cha.
+
+    This file is part of CBraid.
+
+    CBraid is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    CBraid is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CBraid; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+
+/*
+    Benchmark for the meet of factors, which is the main cost of the
+    left canonical form and of the conjugacy test.
+
+    The meet of random factors, the left canonical form of random
+    braids, and the conjugacy test of random conjugate braids are
+    timed.  Compile the library and this program with and without
+    USE_BITSET_MEET to compare the two implementations of the meet.
+*/
+
+
+#include "cbraid.h"
+#include "braiding.h"
+
+#include "optarg.h"
+#include "timecounter.h"
+
+#include <iostream>
+#include <vector>
+#include <cstdlib>
+
+
+// Global option variables.
+int Index = 16;
+int CLength = 20;
+int Count = 20;
+int CLength2 = 3;
+int Count2 = 10;
+int CLibRandomSeed = 0;
+
+
+int main(int argc, char* argv[])
+{
+    using namespace CBraid;
+    using namespace std;
+
+    // Process command line options.
+    OptArg::optmap m;
+    m << OptArg::opt("-index", OptArg::int_arg, &Index)
+      << OptArg::opt("-clength", OptArg::int_arg, &CLength)
+      << OptArg::opt("-count", OptArg::int_arg, &Count)
+      << OptArg::opt("-conjclength", OptArg::int_arg, &CLength2)
+      << OptArg::opt("-conjcount", OptArg::int_arg, &Count2)
+      << OptArg::opt("-srand", OptArg::int_arg, &CLibRandomSeed);
+    try {
+        OptArg::process_option(argv+1, argv+argc, m);
+    }
+    catch (OptArg::bad_optarg_seq e) {
+        cerr << "Bad argument: " << e.option_name << endl;
+        exit(1);
+    }
+
+    if (CLibRandomSeed)
+        DefaultRandomGenerator().Seed(CLibRandomSeed);
+
+#ifdef USE_BITSET_MEET
+    const char* kernel = (Index <= BitsetMeetIndex) ? "bitset" : "table";
+#else
+    const char* kernel = "table";
+#endif
+    cout << "Meet benchmark (" << kernel << "), with parameters n=" << Index
+         << ", l=" << CLength << ", count=" << Count << endl;
+
+    TimeCounter t;
+
+    // Meet of a factor with the complement of another, as in
+    // MakeLeftWeighted().
+    const int Meets = 100000;
+    vector<ArtinFactor> a(Count, ArtinFactor(Index)),
+        b(Count, ArtinFactor(Index));
+    for(int i = 0; i < Count; ++i) {
+        a[i].Randomize();
+        b[i].Randomize();
+        a[i] = ~a[i];
+    }
+    ArtinFactor r(Index);
+    sint32 check = 0;
+    t.Start();
+    for(int k = 0; k < Meets/Count; ++k)
+        for(int i = 0; i < Count; ++i) {
+            r = LeftMeet(a[i], b[i]);
+            check += r[1];
+        }
+    t.Stop();
+    cout << "LeftMeet: " << t.IntervalSec()/(Meets/Count*Count)*1e9
+         << " nsec per meet (" << check << ")" << endl;
+
+    // Left canonical form of braids with negative and positive factors.
+    vector<ArtinBraid> x;
+    for(int i = 0; i < Count; ++i) {
+        ArtinBraid p(Index), q(Index);
+        p.Randomize(CLength);
+        q.Randomize(CLength);
+        x.push_back(p*!q);
+    }
+    t.Start();
+    for(int i = 0; i < Count; ++i) {
+        ArtinBraid y = x[i];
+        y.MakeLCF();
+        check += y.FactorList.size();
+    }
+    t.Stop();
+    cout << "MakeLCF: " << t.IntervalSec()/Count*1e3
+         << " msec per braid (" << check << ")" << endl;
+
+    // Conjugacy test.
+    vector<ArtinBraid> p, z;
+    for(int i = 0; i < Count2; ++i) {
+        ArtinBraid u(Index), v(Index);
+        u.Randomize(CLength2);
+        v.Randomize(CLength2);
+        z.push_back((v*u*!v).MakeLCF());
+        p.push_back(u.MakeLCF());
+    }
+    int conj = 0;
+    t.Start();
+    for(int i = 0; i < Count2; ++i) {
+        ArtinBraid C(Index);
+        conj += Braiding::AreConjugate(p[i], z[i], C);
+    }
+    t.Stop();
+    cout << "AreConjugate: " << t.IntervalSec()/Count2*1e3
+         << " msec per test, " << conj << "/" << Count2
+         << " conjugate pairs found" << endl;
+
+    return (conj == Count2) ? 0 : 1;
+}
@@ -27,12 +27,31 @@
 */
 
 
+/*
+    By default, the left canonical form, the meet of factors, and the
+    conjugacy test are timed on random braids, using -threads threads
+    (this requires C++11).  Each random braid is made by its own
+    RandomGenerator, obtained from the seed by jumps, so the braids and
+    the checksum of the results only depend on the seed, and not on the
+    number of threads.  Rerun with the printed seed (-srand) to repeat
+    a benchmark exactly.
+
+    The original encryption and decryption tests are run with -encrypt
+    and -decrypt.
+*/
+
+
 #include <string>
 #include <iostream>
+#include <iomanip>
+#include <vector>
+#include <thread>
+#include <chrono>
 #include <ctime>
 #include <cmath>
 
 #include "cbraid.h"
+#include "braiding.h"
 
 #include "optarg.h"
 #include "timecounter.h"
@@ -41,12 +60,17 @@
 int Index = 100;
 int CLength = 17;
 int Count = 10;
-bool bEncrypt = true;
+int Threads = 1;
+int Meets = 1000;
+int ConjIndex = 8;
+int ConjCLength = 3;
+bool bEncrypt = false;
+bool bDecrypt = false;
 bool bVerbose = false;
-int RandomSeed;
+int RandomSeed = 0;
 double BlockSize, SecurityLevel;
 
-void Encrypt()
+void Encrypt(CBraid::RandomGenerator& g)
 {
     using namespace CBraid;
     using namespace std;
@@ -55,8 +79,8 @@ void Encrypt()
 
     ArtinBraid x(Index), y(Index), z(Index), b1(Index), b2(Index);
 
-    x.Randomize(CLength);
-    y.Randomize(CLength);
+    x.Randomize(CLength, g);
+    y.Randomize(CLength, g);
     b1 = x;
     for(ArtinBraid::FactorItr i = b1.FactorList.begin();
         i != b1.FactorList.end(); ++i)
@@ -73,10 +97,10 @@ void Encrypt()
                 j = b2.FactorList.begin();
 			i != b1.FactorList.end();
 			++i, ++j) {
-			f.Randomize();
+			f.Randomize(g);
 			for(int k = 1; k <= f.Index(); ++k)
 				(*i)[k] = f[k];
-			f.Randomize();
+			f.Randomize(g);
 			for(int k = 1; k <= f.Index(); ++k)
 				(*j)[k] = f[k];
 
@@ -99,7 +123,7 @@ void Encrypt()
          << BlockSize/8000*Count/t.IntervalSec() << " Kbytes/sec\n";
 }
 
-void Decrypt()
+void Decrypt(CBraid::RandomGenerator& g)
 {
 	using namespace CBraid;
 	using namespace std;
@@ -108,22 +132,22 @@ void Decrypt()
 
 	ArtinBraid a1(Index), a2(Index);
 	ArtinBraid c1(Index), c2(Index), z(Index), w(Index);
-	a1.Randomize(CLength);
-	a2.Randomize(CLength);
+	a1.Randomize(CLength, g);
+	a2.Randomize(CLength, g);
 	ArtinBraid::CanonicalFactor f(Index/2);
 
 	for(ArtinBraid::FactorItr i = a1.FactorList.begin(), j = a2.FactorList.begin();
 		i != a1.FactorList.end();
 		++i, ++j) {
-		f.Randomize();
+		f.Randomize(g);
 		for(int k = 1; k <= f.Index(); ++k)
 			(*i)[k] = f[k];
-		f.Randomize();
+		f.Randomize(g);
 		for(int k = 1; k <= f.Index(); ++k)
 			(*j)[k] = f[k];
 	}
-	c1.Randomize(CLength);
-	c2.Randomize(CLength);
+	c1.Randomize(CLength, g);
+	c2.Randomize(CLength, g);
 
 	t1 = clock();
 
@@ -144,6 +168,134 @@ void Decrypt()
 }
 
 
+// Random input of one task of the benchmark.
+struct Task {
+    CBraid::ArtinBraid LCF, Conj1, Conj2;
+    std::vector<CBraid::ArtinFactor> A, B;
+    CBraid::uint64 Check;
+    int Conjugate;
+    Task() : LCF(Index), Conj1(ConjIndex), Conj2(ConjIndex),
+             Check(0), Conjugate(0) {}
+};
+
+// Mix x into the checksum h.
+inline CBraid::uint64 Mix(CBraid::uint64 h, CBraid::uint64 x)
+{
+    return (h ^ x)*0x100000001b3ULL;
+}
+
+void MakeTask(Task& t, CBraid::RandomGenerator g)
+{
+    using namespace CBraid;
+
+    ArtinBraid p(Index), q(Index), u(ConjIndex), v(ConjIndex);
+    p.Randomize(CLength, g);
+    q.Randomize(CLength, g);
+    t.LCF = p*!q;
+    for(int k = 0; k < Meets; ++k) {
+        t.A.push_back(~ArtinFactor(Index).Randomize(g));
+        t.B.push_back(ArtinFactor(Index).Randomize(g));
+    }
+    u.Randomize(ConjCLength, g);
+    v.Randomize(ConjCLength, g);
+    t.Conj1 = u.MakeLCF();
+    t.Conj2 = (v*u*!v).MakeLCF();
+}
+
+void RunLCF(Task& t)
+{
+    CBraid::ArtinBraid x = t.LCF;
+    x.MakeLCF();
+    t.Check = Mix(t.Check, x.LeftDelta);
+    for(CBraid::ArtinBraid::ConstFactorItr it = x.FactorList.begin();
+        it != x.FactorList.end(); ++it)
+        for(int i = 1; i <= Index; ++i)
+            t.Check = Mix(t.Check, (*it)[i]);
+}
+
+void RunMeets(Task& t)
+{
+    for(size_t k = 0; k < t.A.size(); ++k) {
+        CBraid::ArtinFactor r = CBraid::LeftMeet(t.A[k], t.B[k]);
+        for(int i = 1; i <= Index; ++i)
+            t.Check = Mix(t.Check, r[i]);
+    }
+}
+
+void RunConj(Task& t)
+{
+    CBraid::ArtinBraid C(ConjIndex);
+    t.Conjugate = Braiding::AreConjugate(t.Conj1, t.Conj2, C);
+    t.Check = Mix(t.Check, t.Conjugate);
+}
+
+// Apply f to all the tasks, with the tasks split between Threads
+// threads, and return the elapsed (wall clock) time in seconds.
+template<class F>
+double RunTasks(std::vector<Task>& tasks, F f)
+{
+    std::chrono::steady_clock::time_point t0 =
+        std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for(int th = 0; th < Threads; ++th)
+        pool.push_back(std::thread([&tasks, f, th]() {
+                    for(size_t k = th; k < tasks.size(); k += Threads)
+                        f(tasks[k]);
+                }));
+    for(int th = 0; th < Threads; ++th)
+        pool[th].join();
+    return std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - t0).count();
+}
+
+int Benchmark(CBraid::uint64 seed)
+{
+    using namespace CBraid;
+    using namespace std;
+
+    cout << "Benchmark, with parameters n=" << Index << ", l=" << CLength
+         << ", count=" << Count << ", meets=" << Meets
+         << ", conjugacy n=" << ConjIndex << ", l=" << ConjCLength
+         << ", threads=" << Threads << ", seed=" << seed << endl;
+
+    // The generator of task k is the seed's generator after k jumps.
+    vector<RandomGenerator> gens;
+    RandomGenerator g(seed);
+    for(int k = 0; k < Count; ++k) {
+        gens.push_back(g);
+        g.Jump();
+    }
+
+    vector<Task> tasks(Count);
+    double t = RunTasks(tasks, [&gens, &tasks](Task& x) {
+            MakeTask(x, gens[&x - &tasks[0]]);
+        });
+    cout << "Randomize: " << t/Count*1e3 << " msec per task" << endl;
+
+    t = RunTasks(tasks, RunLCF);
+    cout << "MakeLCF: " << t/Count*1e3 << " msec per braid" << endl;
+
+    t = RunTasks(tasks, RunMeets);
+    cout << "LeftMeet: " << t/(double(Count)*Meets)*1e9
+         << " nsec per meet" << endl;
+
+    t = RunTasks(tasks, RunConj);
+    cout << "AreConjugate: " << t/Count*1e3 << " msec per test" << endl;
+
+    uint64 check = 0;
+    int conj = 0;
+    for(int k = 0; k < Count; ++k) {
+        check = Mix(check, tasks[k].Check);
+        conj += tasks[k].Conjugate;
+    }
+    cout << "Checksum: " << hex << setw(16) << setfill('0') << check
+         << dec << ", " << conj << "/" << Count
+         << " conjugate pairs found" << endl;
+
+    return (conj == Count) ? 0 : 1;
+}
+
+
 int main(int argc, char *argv[])
 {
     using namespace CBraid;
@@ -156,8 +308,12 @@ int main(int argc, char *argv[])
       << OptArg::opt("-lndex", OptArg::int_arg, &Index)
       << OptArg::opt("-CLength", OptArg::int_arg, &CLength)
       << OptArg::opt("-encrypt", OptArg::bool_true_arg, &bEncrypt)
-      << OptArg::opt("-decrypt", OptArg::bool_false_arg, &bEncrypt)
+      << OptArg::opt("-decrypt", OptArg::bool_true_arg, &bDecrypt)
       << OptArg::opt("-count", OptArg::int_arg, &Count)
+      << OptArg::opt("-threads", OptArg::int_arg, &Threads)
+      << OptArg::opt("-meets", OptArg::int_arg, &Meets)
+      << OptArg::opt("-conjindex", OptArg::int_arg, &ConjIndex)
+      << OptArg::opt("-conjclength", OptArg::int_arg, &ConjCLength)
       << OptArg::opt("-verbose", OptArg::bool_true_arg, &bVerbose)
       << OptArg::opt("-srand", OptArg::int_arg, &RandomSeed);
     try {
@@ -168,6 +324,16 @@ int main(int argc, char *argv[])
         exit(1);
     }
 
+    // Without a seed, use the time, and report it so that the run can
+    // be repeated.
+    uint64 seed = RandomSeed ? RandomSeed : std::time(NULL);
+    RandomGenerator g(seed);
+    if (Threads < 1)
+        Threads = 1;
+
+    if (!bEncrypt && !bDecrypt)
+        return Benchmark(seed);
+
     // Report parameters.
     cout << "Encryption test, with parameters n=" << Index
          << ", l=" << CLength << ", count=" << Count << endl;
@@ -184,8 +350,8 @@ int main(int argc, char *argv[])
          << SecurityLevel << endl;
 
 	if (bEncrypt)
-		Encrypt();
+		Encrypt(g);
 	else
-		Decrypt();
+		Decrypt(g);
 	return 0;
 }
@@ -68,6 +68,26 @@ bool CFormMulTest(B& (B::*pMakeCForm)())
     return rc;
 }
 
+template<class B>
+bool IncrementalLCFTest()
+{
+    using namespace CBraid;
+    using namespace std;
+
+    B a(Index), b(Index), c(Index), d(Index);
+
+    cout << "a=" << a.Randomize(CLength) << endl
+        << "b=" << b.Randomize(CLength) << endl;
+    cout << "LCF(a*!b)=" << (c = a*!b).MakeLCF() << endl;
+    d = a.MakeLCF();
+    cout << "LCF(a)*!b=" << d.RightMultiplyLCF(!b).MakeLCF() << endl;
+    bool rc = (c == d);
+    cout << (rc ? "\nPassed: " : "\nFailed: ")
+         << "Incremental left canonical form test for "
+         << TypeName<B>() << endl << endl << flush;
+    return rc;
+}
+
 template <class B>
 bool CFormInvTest(B& (B::*pMakeCForm)())
 {
@@ -176,16 +196,18 @@ int main(int argc, char* argv[])
     }
 
     if (CLibRandomSeed)
-        srand(CLibRandomSeed);
+        DefaultRandomGenerator().Seed(CLibRandomSeed);
 
     if (!CFormMulTest(&ArtinBraid::MakeLCF) ||
         !CFormInvTest(&ArtinBraid::MakeLCF) ||
         !CFormMulTest(&ArtinBraid::MakeRCF) ||
         !CFormInvTest(&ArtinBraid::MakeRCF) ||
+        !IncrementalLCFTest<ArtinBraid>() ||
         !CFormMulTest(&BandBraid::MakeLCF) ||
         !CFormInvTest(&BandBraid::MakeLCF) ||
         !CFormMulTest(&BandBraid::MakeRCF) ||
         !CFormInvTest(&BandBraid::MakeRCF) ||
+        !IncrementalLCFTest<BandBraid>() ||
         !LeftReductionTest(&ArtinBraid::ReduceLeftLower) ||
         !LeftReductionTest(&ArtinBraid::ReduceLeftUpper) ||
         !RightReductionTest(&ArtinBraid::ReduceRightLower) ||
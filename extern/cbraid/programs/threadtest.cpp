@@ -0,0 +1,135 @@
+/*
+    Copyright (C) 2000-2001 Jae Choon Cha.
+
+    This file is part of CBraid.
+
+    CBraid is free software; you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation; either version 2 of the License, or
+    any later version.
+
+    CBraid is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with CBraid; if not, write to the Free Software
+    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307 USA
+*/
+
+
+/*
+    Stress test for concurrent use of CBraid Library.
+
+    Random braids are put in canonical form once serially, and then
+    many times by several threads at once.  The results must agree.
+    This requires C++11 threads.
+*/
+
+
+#include "cbraid.h"
+
+#include "optarg.h"
+
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <atomic>
+
+
+// Global option variables.
+int Index = 8;
+int CLength = 10;
+int Count = 20;
+int Threads = 8;
+int Repeat = 2;
+int CLibRandomSeed = 0;
+
+
+struct Forms {
+    CBraid::ArtinBraid LCF, RCF;
+    CBraid::BandBraid BandLCF, BandRCF;
+    Forms(const CBraid::ArtinBraid& a)
+        : LCF(a), RCF(a), BandLCF(CBraid::ToBandBraid(a)),
+          BandRCF(CBraid::ToBandBraid(a))
+    {
+        LCF.MakeLCF();
+        RCF.MakeRCF();
+        BandLCF.MakeLCF();
+        BandRCF.MakeRCF();
+    }
+    bool operator==(const Forms& f) const
+    {
+        return LCF == f.LCF && RCF == f.RCF &&
+            BandLCF == f.BandLCF && BandRCF == f.BandRCF;
+    }
+};
+
+
+void Worker(int t, const std::vector<CBraid::ArtinBraid>& a,
+            const std::vector<Forms>& forms, std::atomic<int>& failures)
+{
+    for(int r = 0; r < Repeat; ++r) {
+        // Each thread goes through the braids in a different order.
+        for(size_t k = 0; k < a.size(); ++k) {
+            size_t i = (k*(2*t+1) + r) % a.size();
+            if (!(Forms(a[i]) == forms[i]))
+                ++failures;
+        }
+    }
+}
+
+
+int main(int argc, char* argv[])
+{
+    using namespace CBraid;
+    using namespace std;
+
+    // Process command line options.
+    OptArg::optmap m;
+    m << OptArg::opt("-index", OptArg::int_arg, &Index)
+      << OptArg::opt("-clength", OptArg::int_arg, &CLength)
+      << OptArg::opt("-count", OptArg::int_arg, &Count)
+      << OptArg::opt("-threads", OptArg::int_arg, &Threads)
+      << OptArg::opt("-repeat", OptArg::int_arg, &Repeat)
+      << OptArg::opt("-srand", OptArg::int_arg, &CLibRandomSeed);
+    try {
+        OptArg::process_option(argv+1, argv+argc, m);
+    }
+    catch (OptArg::bad_optarg_seq e) {
+        cerr << "Bad argument: " << e.option_name << endl;
+        exit(1);
+    }
+
+    if (CLibRandomSeed)
+        DefaultRandomGenerator().Seed(CLibRandomSeed);
+
+    // Random braids and their canonical forms, computed serially.
+    // Randomize() uses the default generator, which is shared, so it
+    // is not called from the threads.
+    vector<ArtinBraid> a;
+    vector<Forms> forms;
+    for(int i = 0; i < Count; ++i) {
+        ArtinBraid x(Index), y(Index);
+        x.Randomize(CLength);
+        y.Randomize(CLength);
+        a.push_back(x*!y);
+        forms.push_back(Forms(a.back()));
+    }
+
+    atomic<int> failures(0);
+    vector<thread> pool;
+    for(int t = 0; t < Threads; ++t)
+        pool.push_back(thread(Worker, t, cref(a), cref(forms),
+                              ref(failures)));
+    for(int t = 0; t < Threads; ++t)
+        pool[t].join();
+
+    cout << (failures == 0 ? "Passed" : "Failed")
+         << ": canonical forms of " << Count << " braids with index "
+         << Index << " in " << Threads << " threads, "
+         << failures << " mismatches" << endl << flush;
+
+    return (failures == 0) ? 0 : 1;
+}
@@ -288,6 +288,13 @@ classdef annbraidTest < matlab.unittest.TestCase
                            'BRAIDLAB:annbraid:subbraid:undefined');
     end
 
+    function test_hidden_linkmatrix_error(testCase)
+      % Test that linkmatrix method errors for annbraid.
+      ab = testCase.ab1m2;
+      testCase.verifyError(@() linkmatrix(ab), ...
+                           'BRAIDLAB:annbraid:linkmatrix:undefined');
+    end
+
     %% istrivial method tests
 
     function test_istrivial_identity(testCase)
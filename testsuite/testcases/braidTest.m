@@ -371,6 +371,110 @@ classdef braidTest < matlab.unittest.TestCase
       end
     end
 
+    function test_trajectory_multiproj(testCase)
+      % Test that multiproj agrees with braid/databraid for each angle.
+      rng(1);
+      XY = braidlab.closure(randn(50,2,4));
+      t = linspace(0,1,size(XY,1));
+      angles = [0 pi/7 1 2.5];
+
+      [b,tcr] = braidlab.braid.multiproj(XY,angles,t);
+      testCase.verifySize(b,[1 numel(angles)]);
+      testCase.verifyClass(tcr,'cell');
+      for k = 1:numel(angles)
+        db = braidlab.databraid(XY,t,angles(k));
+        testCase.verifyTrue(lexeq(b(k),braidlab.braid(db)));
+        testCase.verifyEqual(tcr{k}(:).',db.tcross);
+      end
+
+      % A single angle still returns a cell array of crossing times.
+      [b1,tcr1] = braidlab.braid.multiproj(XY,angles(2),t);
+      testCase.verifyTrue(lexeq(b1,b(2)));
+      testCase.verifyEqual(tcr1,tcr(2));
+    end
+
+    function test_trajectory_multiproj_error(testCase)
+      % Errors for several angles report the angle that caused them.
+      XY = zeros(4,2,2);
+      XY(:,2,2) = 2;
+      try
+        braidlab.braid.multiproj(XY,[.1 0 .2]);
+        testCase.verifyFail('No error for a coincident projection.');
+      catch me
+        testCase.verifyEqual(me.identifier, ...
+                     'BRAIDLAB:braid:colorbraiding:coincidentprojection');
+        testCase.verifySubstring(me.message,'projection angle 0 (number 2)');
+      end
+    end
+
+    function test_trajectory_profile(testCase)
+      % Test the profile returned by the C++ crossing detection.
+      rng(1);
+      XY = braidlab.closure(randn(50,2,4));
+      [b,tcr,prof] = braidlab.braid.multiproj(XY,0);
+      testCase.assumeNotEmpty(prof, ...
+                              'The MATLAB version does not return a profile.');
+      testCase.verifyEqual(prof.crossings, numel(tcr{1}));
+      testCase.verifyEqual(prof.crossings, length(b));
+      testCase.verifyEqual(sum((1:numel(prof.blocksizes)).' .* ...
+                               prof.blocksizes), prof.crossings);
+      testCase.verifyEqual(sum(prof.threadtasks), size(XY,3));
+      phases = {'detection','sort','blocks','output'};
+      testCase.verifyTrue(all(isfield(prof.wall,phases)));
+      testCase.verifyTrue(all(isfield(prof.cpu,phases)));
+    end
+
+    function test_trajectory_multiproj_matlab(testCase)
+      % Test that the MATLAB version of multiproj agrees with the MEX one.
+      global BRAIDLAB_braid_nomex %#ok<GVMIS>
+      flagstate = BRAIDLAB_braid_nomex;
+
+      rng(2);
+      XY = braidlab.closure(randn(30,2,4));
+      angles = [0.1 1.3 -0.4];
+
+      BRAIDLAB_braid_nomex = false;
+      bMex = braidlab.braid.multiproj(XY,angles);
+      BRAIDLAB_braid_nomex = true;
+      bMat = braidlab.braid.multiproj(XY,angles);
+
+      BRAIDLAB_braid_nomex = flagstate;
+      if isempty(flagstate)
+        clear global BRAIDLAB_braid_nomex
+      end
+
+      for k = 1:numel(angles)
+        testCase.verifyTrue(lexeq(bMex(k),bMat(k)));
+      end
+    end
+
+    function test_trajectory_multiproj_coincident_error(testCase)
+      % Test that multiproj reports coincident particles by original index.
+      XY = zeros(4,2,3);
+      XY(:,:,1) = [0 0; 1 1; 2 0; 0 0];
+      XY(:,:,2) = [5 5; 5 5; 5 5; 5 5];
+      XY(:,:,3) = [0 0; 1 1; 2 0; 0 0];
+
+      testCase.verifyError(@() braidlab.braid.multiproj(XY,[0 1]), ...
+                           'BRAIDLAB:braid:colorbraiding:coincidentparticles');
+    end
+
+    function test_trajectory_simultaneous_block(testCase)
+      % Test large blocks of simultaneous crossings (lattice-like data).
+      % All strings reverse their order at the same time, twice.
+      n = 20;
+      i = reshape(1:n,[1 1 n]);
+      XY = zeros(3,2,n);
+      XY(:,1,:) = [i; -i; i];
+      XY(:,2,:) = [i; i; -2*i];
+      XY = braidlab.closure(XY);
+
+      b = braidlab.braid(XY);
+      testCase.verifyEqual(length(b),n*(n-1));
+      testCase.verifyTrue(b == braidlab.braid('FullTwist',n) || ...
+                          b == braidlab.braid('FullTwist',n)^-1);
+    end
+
     function test_trajectory_invalid_projection_error(testCase)
       % Test that invalid projection angles error.
       XY = zeros(3,2,2);
@@ -432,6 +536,29 @@ classdef braidTest < matlab.unittest.TestCase
       testCase.verifyClass(b.word,'int32');
     end
 
+    function test_trajectory_single_precision(testCase)
+      % Test that single-precision trajectories give the same braid.
+      XY = zeros(3,2,2);
+      XY(:,:,1) = [0 0; 1.5 1; 2 0];
+      XY(:,:,2) = [2 0; 0.5 -1; 0 0];
+
+      b1 = braidlab.braid(braidlab.closure(XY));
+      b2 = braidlab.braid(braidlab.closure(single(XY)));
+      testCase.verifyTrue(lexeq(b1,b2));
+
+      % Projection angles also work on single data.
+      b1 = braidlab.braid(XY,pi/6);
+      b2 = braidlab.braid(single(XY),pi/6);
+      testCase.verifyTrue(lexeq(b1,b2));
+
+      % Crossing times are always double.
+      db1 = braidlab.databraid(XY);
+      db2 = braidlab.databraid(single(XY));
+      testCase.verifyClass(db2.tcross,'double');
+      testCase.verifyEqual(db2.word,db1.word);
+      testCase.verifyEqual(db2.tcross,db1.tcross,'AbsTol',1e-6);
+    end
+
     %% Generator range tests
 
     function test_generator_within_bounds(testCase)
@@ -673,6 +800,18 @@ classdef braidTest < matlab.unittest.TestCase
       testCase.verifyTrue(istrivial(b));
     end
 
+    function test_istrivial_long(testCase)
+      % Test long braids whose loop coordinates overflow int64.
+      rng('default')
+      b = braidlab.braid('random',8,5000);
+      c = compact(b);
+      testCase.verifyTrue(istrivial(b*inv(c)));
+      testCase.verifyFalse(istrivial(b*inv(c)*braidlab.braid(1,8)));
+      testCase.verifyWarningFree(@() b == c);
+      testCase.verifyTrue(b == c);
+      testCase.verifyFalse(b == c*braidlab.braid(-3,8));
+    end
+
     %% ispure method tests
 
     function test_ispure_basic(testCase)
@@ -913,6 +1052,56 @@ classdef braidTest < matlab.unittest.TestCase
       testCase.verifyEqual(bs.n,4);
     end
 
+    function test_subbraid_nested(testCase)
+      % Test that a subbraid of a subbraid is a subbraid, on many strings.
+      rng('default')
+      b = braidlab.braid('random',60,20000);
+      s = sort(randperm(60,30));
+      bs = subbraid(b,s);
+      testCase.verifyTrue(lexeq(subbraid(bs,1:3:30),subbraid(b,s(1:3:30))));
+      testCase.verifyTrue(lexeq(subbraid(b,1:60),b));
+    end
+
+    function test_subbraid_batch(testCase)
+      % Test subbraids of a cell array of subsets.
+      rng('default')
+      b = braidlab.braid('random',12,2000);
+      s = num2cell(nchoosek(1:12,3),2);
+      s{end+1} = [12 1 5 1];
+      bs = subbraid(b,s);
+      testCase.verifySize(bs,size(s));
+      for k = 1:length(s)
+        testCase.verifyTrue(lexeq(bs{k},subbraid(b,s{k})));
+      end
+      testCase.verifyError(@() subbraid(b,{[1 2],[0 3]}), ...
+                           'BRAIDLAB:braid:subbraid:badstring');
+    end
+
+    %% linkmatrix method tests
+
+    function test_linkmatrix_subbraid(testCase)
+      % Test that the linking matrix agrees with writhes of subbraids.
+      rng('default')
+      b = braidlab.braid('random',7,3000);
+      W = linkmatrix(b);
+      testCase.verifyEqual(W,W.');
+      testCase.verifyEqual(diag(W),zeros(7,1));
+      for i = 1:7
+        for j = i+1:7
+          testCase.verifyEqual(W(i,j),writhe(subbraid(b,[i j])));
+        end
+      end
+      testCase.verifyEqual(sum(W(:))/2,writhe(b));
+    end
+
+    function test_linkmatrix_pure(testCase)
+      % Test the winding numbers of a pure braid.
+      b = braidlab.braid([1 1 2 2 2 2 -3 -3],4);
+      W = linkmatrix(b)/2;
+      testCase.verifyEqual(W,[0 1 0 0; 1 0 2 0; 0 2 0 -1; 0 0 -1 0]);
+      testCase.verifyEqual(linkmatrix(braidlab.braid([],3)),zeros(3));
+    end
+
     %% char method tests
 
     function test_char_nonempty(testCase)
@@ -1139,6 +1328,29 @@ classdef braidTest < matlab.unittest.TestCase
       testCase.verifyEqual(size(XYc,1), size(XY,1)+1);
     end
 
+    function test_closure_mindist_optimal(testCase)
+      % Test MinDist closure total distance matches the Hungarian solution.
+      rng(1);
+      n = 400;
+      XY = zeros(5,2,n);
+      XY(1,:,:) = rand(1,2,n);
+      XY(end,:,:) = XY(1,:,randperm(n)) + .01*randn(1,2,n);
+      XYc = braidlab.closure(XY,'MinDist');
+      testCase.verifyEqual(size(XYc,1), size(XY,1)+1);
+      XY0 = squeeze(XY(1,:,:));
+      XY1 = squeeze(XY(end,:,:));
+      % The closing points must be a permutation of the initial points.
+      testCase.verifyEqual(sortrows(squeeze(XYc(end,:,:)).'), ...
+                           sortrows(XY0.'));
+      D = zeros(n,n);
+      for i = 1:n
+        D(i,:) = sqrt(sum((XY0 - XY1(:,i)).^2,1));
+      end
+      [~,cost] = braidlab.util.assignmentoptimal(D);
+      costc = sum(sqrt(sum((squeeze(XYc(end,:,:)) - XY1).^2,1)));
+      testCase.verifyLessThanOrEqual(costc, cost + 1e-8);
+    end
+
     function test_closure_permutation(testCase)
       % Test closure with explicit permutation.
       XY = zeros(10,2,3);
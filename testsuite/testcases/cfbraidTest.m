@@ -197,6 +197,86 @@ classdef cfbraidTest < matlab.unittest.TestCase
       testCase.verifyTrue(contains(str, 'D^'));
     end
 
+    %% mtimes tests
+
+    function test_mtimes_generators(testCase)
+      % Appending generators agrees with the canonical form of the word.
+      rng('default')
+      w = randi([-4 4],1,100); w = w(w ~= 0);
+      cfb = braidlab.cfbraid(w,5);
+      for g = [1 -1 4 -4 2 -3]
+        testCase.verifyEqual(cfb*g, braidlab.cfbraid([w g],5));
+      end
+      testCase.verifyEqual(cfb*[2 -3 -3 1], braidlab.cfbraid([w 2 -3 -3 1],5));
+      testCase.verifyEqual(braidlab.cfbraid([])*[], braidlab.cfbraid([]));
+    end
+
+    function test_mtimes_braids(testCase)
+      % Products with braids and cfbraids, and with more strings.
+      b1 = braidlab.braid([1 -2 3 1]);
+      b2 = braidlab.braid([-3 -3 2]);
+      cfb = braidlab.cfbraid(b1);
+      testCase.verifyEqual(cfb*b2, braidlab.cfbraid(b1*b2));
+      testCase.verifyEqual(cfb*braidlab.cfbraid(b2), braidlab.cfbraid(b1*b2));
+      testCase.verifyEqual(cfb*5, braidlab.cfbraid([b1.word 5]));
+      testCase.verifyError(@() cfb*0, 'BRAIDLAB:cfbraid:mtimes:badgen');
+      testCase.verifyError(@() 2*cfb, 'BRAIDLAB:cfbraid:mtimes:badobject');
+    end
+
+    %% normalforms tests
+
+    function test_normalforms(testCase)
+      % Batch canonical forms agree with cfbraid.
+      rng('default')
+      W = cell(1,50);
+      for k = 1:numel(W)
+        w = randi([-4 4],1,randi(20));
+        W{k} = w(w ~= 0);
+      end
+      W{7} = [];
+      [delta,gen,facptr,brptr] = braidlab.cfbraid.normalforms(W,5);
+      testCase.verifyEqual(length(brptr), numel(W)+1);
+      for k = 1:numel(W)
+        cfb = braidlab.cfbraid(W{k},5);
+        testCase.verifyEqual(delta(k), cfb.delta);
+        f = brptr(k):brptr(k+1)-1;
+        testCase.verifyEqual(arrayfun(@(i) gen(facptr(i):facptr(i+1)-1), ...
+                                      f, 'UniformOutput', false), ...
+                             cfb.factors);
+      end
+      testCase.verifyError(@() braidlab.cfbraid.normalforms({[1 5]},5), ...
+                           'BRAIDLAB:cfbraid:normalforms:badgen');
+    end
+
+    function test_normalforms_rcf(testCase)
+      % Right canonical forms represent the same braids.
+      br = [braidlab.braid([1 2 -3]) braidlab.braid([-1 -1 2 3 -2])];
+      [delta,gen,facptr,brptr] = braidlab.cfbraid.normalforms(br,[],'rcf');
+      D = braidlab.braid('halftwist',4);
+      for k = 1:numel(br)
+        w = braidlab.braid(gen(facptr(brptr(k)):facptr(brptr(k+1))-1),4);
+        testCase.verifyTrue(w * D^delta(k) == br(k));
+      end
+    end
+
+    function test_normalforms_bkl(testCase)
+      % Band generator normal forms represent the same braids.
+      n = 5;
+      br = [braidlab.braid([1 2 -3 4]) braidlab.braid([-1 -1 2 3 -2 -4]) ...
+            braidlab.braid([4 -3 2 2 1 -4 -4]) braidlab.braid([],5)];
+      [delta,gen,facptr,brptr] = braidlab.cfbraid.normalforms(br,[],'bkl');
+      testCase.verifyEqual(size(gen,1), 2);
+      d = braidlab.braid(n-1:-1:1,n);
+      for k = 1:numel(br)
+        w = [];
+        for i = facptr(brptr(k)):facptr(brptr(k+1))-1
+          t = double(gen(1,i)); s = double(gen(2,i));
+          w = [w t-1:-1:s+1 s -(s+1:t-1)]; %#ok<AGROW>
+        end
+        testCase.verifyTrue(d^delta(k) * braidlab.braid(w,n) == br(k));
+      end
+    end
+
     %% conjtest tests
 
     function test_conjtest_samebraid(testCase)
@@ -82,6 +82,14 @@ classdef compactTest < matlab.unittest.TestCase
       testCase.verifyTrue(istrivial(c));
     end
 
+    function test_cancel_braidrelation(testCase)
+      % Test a word whose compaction depends on the order of the moves,
+      % which must be that of the original passes.
+      br = braidlab.braid([-3 1 2 1 -2 3 -1 -3], 4);
+      c = compact(br);
+      testCase.verifyTrue(lexeq(c, braidlab.braid([-3 2], 4)));
+    end
+
     %% Preservation tests
 
     function test_preserve_equality(testCase)
@@ -103,6 +111,91 @@ classdef compactTest < matlab.unittest.TestCase
       end
     end
 
+    function test_preserve_long(testCase)
+      % Test compact on a long word with distant cancellations.
+      rng('default')
+      br = braidlab.braid('random', 8, 20000);
+      c = compact(br*inv(br));
+      testCase.verifyTrue(istrivial(c));
+      testCase.verifyTrue(isempty(c.word));
+      c = compact(br);
+      testCase.verifyLessThanOrEqual(length(c), length(br));
+      testCase.verifyTrue(br == c, 'Braids not equal after compacting.');
+    end
+
+    function test_preserve_threads(testCase)
+      % Test parallel compact on a word long enough to be split.
+      global BRAIDLAB_threads %#ok<GVMIS>
+      threads0 = BRAIDLAB_threads;
+      testCase.addTeardown(@() setthreads(threads0));
+      rng('default')
+      br = braidlab.braid('random', 6, 50000);
+      setthreads(1); c = compact(br); c1 = compact(br, 'Parallel');
+      setthreads(4); c4 = compact(br, 'Parallel');
+      % Neither result depends on the number of threads.
+      testCase.verifyEqual(compact(br).word, c.word);
+      testCase.verifyEqual(c4.word, c1.word);
+      testCase.verifyTrue(br == c4, 'Braids not equal after compacting.');
+      testCase.verifyLessThanOrEqual(length(c4), 1.01*length(c));
+    end
+
+    function test_preserve_handle(testCase)
+      % Test compact with handle reduction on long words.
+      rng('default')
+      br = braidlab.braid('random', 8, 5000);
+      c = compact(br);
+      % Plain compact usually leaves some of br*inv(c), but handle
+      % reduction removes all of it.
+      testCase.verifyTrue(isempty(compact(br*inv(c), 'Handle').word));
+      ch = compact(br, 'Handle');
+      testCase.verifyLessThanOrEqual(length(ch), length(c));
+      testCase.verifyTrue(br == ch, 'Braids not equal after compacting.');
+      ab = braidlab.annbraid([3 1 -3], 3);
+      testCase.verifyError(@() compact(ab, 'Handle'), ...
+                           'BRAIDLAB:braid:compact:badarg');
+    end
+
+    %% Foata normal form tests
+
+    function test_foata_commute(testCase)
+      % Test that words equal up to commutations have the same normal form.
+      b1 = braidlab.braid([1 3 -5 2 4 1 -3], 6);
+      b2 = braidlab.braid([3 1 2 -5 4 1 -3], 6);
+      b3 = braidlab.braid([-5 3 1 2 4 2 -2 1 -3], 6);
+      testCase.verifyTrue(lexeq(foata(b1), foata(b2)));
+      testCase.verifyTrue(lexeq(foata(b1), foata(b3)));
+      [c,layers] = foata(b1);
+      testCase.verifyEqual(c.word, int32([1 3 -5 2 4 1 -3]));
+      testCase.verifyEqual(layers, [3 2 2]);
+    end
+
+    function test_foata_cancel(testCase)
+      % Test that the normal form cancels generators with their inverse.
+      rng('default')
+      br = braidlab.braid('random', 8, 5000);
+      c = foata(br*inv(br));
+      testCase.verifyTrue(isempty(c.word));
+      [c,layers] = foata(br);
+      testCase.verifyEqual(sum(layers), length(c));
+      testCase.verifyTrue(br == c, 'Braids not equal after normal form.');
+      testCase.verifyTrue(lexeq(foata(c), c));
+    end
+
+    function test_foata_compact(testCase)
+      % Test the fast compact mode and its annular version.
+      rng('default')
+      br = braidlab.braid('random', 10, 1000);
+      c = compact(br, 'Foata');
+      testCase.verifyTrue(lexeq(c, foata(br)));
+      testCase.verifyTrue(br == c, 'Braids not equal after compacting.');
+      % Generators 1 and 3 don't commute for an annular braid on 3 strings.
+      ab = braidlab.annbraid([3 1 -3], 3);
+      testCase.verifyEqual(compact(ab, 'Foata').word, int32([3 1 -3]));
+      testCase.verifyEqual(foata(ab.braid).word, int32(1));
+      testCase.verifyError(@() compact(br, 'bad'), ...
+                           'BRAIDLAB:braid:compact:badarg');
+    end
+
     %% Output format tests
 
     function test_output_emptyword(testCase)
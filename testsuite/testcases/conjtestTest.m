@@ -78,6 +78,65 @@ classdef conjtestTest < matlab.unittest.TestCase
       testCase.verifyEqual(C, braidlab.braid([-3 -2 -3 -1 -2 -3 1 2 1 2]));
     end
 
+    function test_conjugate_threads(testCase)
+      % The conjugating braid does not depend on the number of threads.
+      global BRAIDLAB_threads %#ok<GVMIS>
+      threads0 = BRAIDLAB_threads;
+      testCase.addTeardown(@() setthreads(threads0));
+      br1 = braidlab.braid([-2 7 -2 -6 -2 1], 8);
+      c = braidlab.braid([1 3 -5 2], 8);
+      br2 = c * br1 * c.inv;
+      setthreads(1); [isconj1, C1] = conjtest(br1, br2);
+      setthreads(4); [isconj4, C4] = conjtest(br1, br2);
+      testCase.verifyTrue(isconj1 && isconj4);
+      testCase.verifyTrue(inv(C4) * br1 * C4 == br2);
+      testCase.verifyEqual(C4, C1);
+      setthreads(4);
+      testCase.verifyFalse(conjtest(br1, braidlab.braid([1 2 3 4 5 6 7], 8)));
+    end
+
+    function test_conjugate_methods(testCase)
+      % Sliding circuits and the automatic mode find valid conjugators.
+      br1 = braidlab.braid([-2 7 -2 -6 -2 1], 8);
+      c = braidlab.braid([1 3 -5 2], 8);
+      br2 = c * br1 * c.inv;
+      for method = {'uss', 'sc', 'auto'}
+        [isconj, C] = conjtest(br1, br2, method{1});
+        testCase.verifyTrue(isconj);
+        testCase.verifyTrue(inv(C) * br1 * C == br2);
+        testCase.verifyTrue(conjtest(br1, br2, method{1}));
+      end
+      br3 = braidlab.braid([1 -2 1 2 2 -1], 4);
+      testCase.verifyFalse(conjtest(braidlab.braid([1 1], 4), br3, 'sc'));
+      testCase.verifyError(@() conjtest(br1, br2, 'foo'), ...
+                           'BRAIDLAB:cfbraid:conjtest:badarg');
+    end
+
+    function test_conjugate_bkl(testCase)
+      % The band generator method finds valid conjugators.
+      br1 = braidlab.braid([-2 4 -2 -3 -2 1], 5);
+      c = braidlab.braid([1 3 -4 2], 5);
+      br2 = c * br1 * c.inv;
+      [isconj, C] = conjtest(br1, br2, 'bkl');
+      testCase.verifyTrue(isconj);
+      testCase.verifyTrue(inv(C) * br1 * C == br2);
+      br3 = braidlab.braid([1 -2 1 2 2 -1], 4);
+      testCase.verifyTrue(conjtest(braidlab.braid([1 2], 4), br3, 'bkl'));
+      testCase.verifyFalse(conjtest(braidlab.braid([1 1], 4), br3, 'bkl'));
+    end
+
+    function test_conjugate_bkl_manystrings(testCase)
+      % The band generator method does not enumerate all the positive
+      % factors, of which there are Catalan(16) here.
+      br1 = braidlab.braid([1 5], 16);
+      c = braidlab.braid([2 3 -7 8 9 -4 12], 16);
+      br2 = c * br1 * c.inv;
+      [isconj, C] = conjtest(br1, br2, 'bkl');
+      testCase.verifyTrue(isconj);
+      testCase.verifyTrue(inv(C) * br1 * C == br2);
+      testCase.verifyFalse(conjtest(braidlab.braid([1 1], 16), br2, 'bkl'));
+    end
+
     %% Non-conjugate braids tests
 
     function test_nonconjugate_different(testCase)
@@ -282,6 +282,23 @@ classdef databraidTest < matlab.unittest.TestCase
       testCase.verifyEqual(dbc.tcross, 3);
     end
 
+    function test_compact_reduce_online(testCase)
+      % Test reducing the generators as the databraid is constructed.
+      testCase.addTeardown(@() braidlab.prop('reset'));
+      data = load('testdata','XY','ti');
+      db = testCase.dbrtest;
+      braidlab.prop('BraidReduce','cancel');
+      db1 = braidlab.databraid(data.XY,data.ti);
+      testCase.verifyTrue(lexeq(braid(db1), braid(compact(db))));
+      braidlab.prop('BraidReduce','commute');
+      db2 = braidlab.databraid(data.XY,data.ti);
+      testCase.verifyLessThanOrEqual(length(db2), length(db1));
+      testCase.verifyTrue(braid(db2) == braid(db));
+      % The surviving generators keep their crossing times.
+      testCase.verifyTrue(all(ismember(db2.tcross, db.tcross)));
+      testCase.verifyTrue(issorted(db2.tcross));
+    end
+
     %% tensor tests
 
     function test_tensor_two(testCase)
@@ -375,6 +392,18 @@ classdef databraidTest < matlab.unittest.TestCase
       testCase.verifyEqual(dbs.word, int32(1));
     end
 
+    function test_subbraid_batch(testCase)
+      % Verify subbraids of a cell array of subsets keep crossing times.
+      dbr = testCase.dbrtest;
+      s = num2cell(nchoosek(1:dbr.n,2),2);
+      dbs = dbr.subbraid(s);
+      for k = 1:length(s)
+        dbk = dbr.subbraid(s{k});
+        testCase.verifyEqual(dbs{k}.word, dbk.word);
+        testCase.verifyEqual(dbs{k}.tcross, dbk.tcross);
+      end
+    end
+
     %% Hidden inherited methods tests
 
     function test_hidden_mpower(testCase)
@@ -0,0 +1,35 @@
+function setthreads(nthreads)
+%SETTHREADS   Set the number of threads used by braidlab in the tests.
+%   SETTHREADS(N) sets the global BRAIDLAB_threads to N, and clears the
+%   number of threads cached by getAvailableThreadNumber so that it is
+%   recomputed.  SETTHREADS([]) restores the default.
+%
+%   See also BRAIDLAB.UTIL.GETAVAILABLETHREADNUMBER.
+
+% <LICENSE
+%   Braidlab: a Matlab package for analyzing data using braids
+%
+%   https://github.com/jeanluct/braidlab
+%
+%   Copyright (C) 2013-2026  Jean-Luc Thiffeault <jeanluc@math.wisc.edu>
+%                            Marko Budisic          <mbudisic@gmail.com>
+%
+%   This file is part of Braidlab.
+%
+%   Braidlab is free software: you can redistribute it and/or modify
+%   it under the terms of the GNU General Public License as published by
+%   the Free Software Foundation, either version 3 of the License, or
+%   (at your option) any later version.
+%
+%   Braidlab is distributed in the hope that it will be useful,
+%   but WITHOUT ANY WARRANTY; without even the implied warranty of
+%   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+%   GNU General Public License for more details.
+%
+%   You should have received a copy of the GNU General Public License
+%   along with Braidlab.  If not, see <https://www.gnu.org/licenses/>.
+% LICENSE>
+
+global BRAIDLAB_threads %#ok<GVMIS>
+BRAIDLAB_threads = nthreads;
+clear braidlab.util.getAvailableThreadNumber
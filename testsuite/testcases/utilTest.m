@@ -126,6 +126,7 @@ classdef utilTest < matlab.unittest.TestCase
       testCase.verifyTrue(isfield(p, 'GenPlotOverUnder'));
       testCase.verifyTrue(isfield(p, 'BraidPlotDir'));
       testCase.verifyTrue(isfield(p, 'BraidAbsTol'));
+      testCase.verifyTrue(isfield(p, 'BraidReduce'));
       testCase.verifyTrue(isfield(p, 'LoopCoordsBasePoint'));
     end
 
@@ -137,6 +138,7 @@ classdef utilTest < matlab.unittest.TestCase
       testCase.verifyEqual(braidlab.prop('GenPlotOverUnder'), true);
       testCase.verifyEqual(braidlab.prop('BraidPlotDir'), 'bt');
       testCase.verifyEqual(braidlab.prop('BraidAbsTol'), 1e-10);
+      testCase.verifyEqual(braidlab.prop('BraidReduce'), 'none');
       testCase.verifyEqual(braidlab.prop('LoopCoordsBasePoint'), 'right');
     end
 
@@ -172,6 +174,16 @@ classdef utilTest < matlab.unittest.TestCase
       braidlab.prop('reset');
     end
 
+    function test_prop_set_braidreduce(testCase)
+      % Test setting BraidReduce property.
+      braidlab.prop('reset');
+      braidlab.prop('BraidReduce', 'Commute');
+      testCase.verifyEqual(braidlab.prop('BraidReduce'), 'commute');
+      testCase.verifyError(@() braidlab.prop('BraidReduce', 'all'), ...
+                           'MATLAB:InputParser:ArgumentFailedValidation');
+      braidlab.prop('reset');
+    end
+
     function test_prop_set_loopcoordsbasepoint(testCase)
       % Test setting LoopCoordsBasePoint property.
       braidlab.prop('reset');